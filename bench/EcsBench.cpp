@@ -0,0 +1,257 @@
+/**
+ * @file EcsBench.cpp
+ * @brief Times the core ECS operations at several entity counts and prints the results as JSON.
+ * Usage: ecs_bench [--repeat n] [--max entities] [--out file]
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "EcsDirector.h"
+#include "Prefab.h"
+#include "System.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench
+{
+    struct Position { float x { 0.f }; float y { 0.f }; float z { 0.f }; };
+    struct Velocity { float x { 1.f }; float y { 1.f }; float z { 1.f }; };
+
+    /** Flag components that only exist to move entities in and out of systems. */
+    template<int I>
+    struct Tag { int value { I }; };
+
+    constexpr int tagCount = 8;
+    constexpr int churnSystemCount = 24;
+
+    class MoveSystem : public System
+    {
+    public:
+        void run()
+        {
+            beginRun();
+            view<Position, const Velocity>().each([](ecs::entity, Position &position, const Velocity &velocity) {
+                position.x += velocity.x;
+                position.y += velocity.y;
+                position.z += velocity.z;
+            });
+        }
+    };
+
+    /** Every churn system matches a different pair of tags so that each signature change has to visit them all. */
+    template<int I>
+    class ChurnSystem : public System {};
+
+    struct result
+    {
+        std::string name;
+        size_t entities;
+        double bestMs;
+        double medianMs;
+    };
+
+    typedef std::chrono::steady_clock timer;
+
+    /**
+     * Runs setup and then times run, repeat times, each on a fresh world.
+     * @return The best and median times in milliseconds.
+     */
+    template<typename Setup, typename Run>
+    result measure(std::string_view name, size_t count, int repeat, Setup setup, Run run)
+    {
+        std::vector<double> times;
+        for (int i = 0; i < repeat; ++i)
+        {
+            auto director = std::make_unique<EcsDirector>();
+            auto state = setup(*director);
+
+            const auto start = timer::now();
+            run(*director, state);
+            const auto end = timer::now();
+            times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        return { std::string(name), count, times.front(), times[times.size() / 2] };
+    }
+
+    void registerComponents(EcsDirector &director)
+    {
+        director.registerComponent<Position>();
+        director.registerComponent<Velocity>();
+    }
+
+    template<int... I>
+    void registerTags(EcsDirector &director, std::integer_sequence<int, I...>)
+    {
+        (director.registerComponent<Tag<I>>(), ...);
+    }
+
+    template<int... I>
+    void registerChurnSystems(EcsDirector &director, std::integer_sequence<int, I...>)
+    {
+        (director.registerSystem<ChurnSystem<I>>(), ...);
+        (director.setSystemSignature<ChurnSystem<I>, Tag<I % tagCount>, Tag<(I / tagCount + I + 1) % tagCount>>(), ...);
+    }
+
+    template<int... I>
+    void toggleTags(EcsDirector &director, ecs::entity entity, std::integer_sequence<int, I...>)
+    {
+        (director.addComponent(entity, Tag<I>()), ...);
+        (director.removeComponent<Tag<I>>(entity), ...);
+    }
+
+    struct world
+    {
+        std::vector<ecs::entity> entities;
+        std::shared_ptr<MoveSystem> moveSystem;
+    };
+
+    /** @return A world with count entities that each have a Position and Velocity. */
+    world makePopulated(EcsDirector &director, size_t count)
+    {
+        registerComponents(director);
+        world state;
+        state.moveSystem = director.registerSystem<MoveSystem>();
+        director.setSystemSignature<MoveSystem, Position, Velocity>();
+
+        Prefab prefab;
+        prefab.add(Position()).add(Velocity());
+        state.entities = director.createEntities(count, prefab);
+        return state;
+    }
+
+    std::vector<result> run(size_t count, int repeat)
+    {
+        std::vector<result> results;
+        const auto empty = [](EcsDirector &director) { registerComponents(director); return world(); };
+        const auto populated = [count](EcsDirector &director) { return makePopulated(director, count); };
+        const auto withEntities = [count](EcsDirector &director) {
+            registerComponents(director);
+            world state;
+            for (size_t i = 0; i < count; ++i) { state.entities.push_back(director.createEntity()); }
+            return state;
+        };
+
+        results.push_back(measure("create", count, repeat, empty, [count](EcsDirector &director, world &) {
+            for (size_t i = 0; i < count; ++i) { director.createEntity(); }
+        }));
+
+        results.push_back(measure("createPrefab", count, repeat, empty, [count](EcsDirector &director, world &) {
+            Prefab prefab;
+            prefab.add(Position()).add(Velocity());
+            director.createEntities(count, prefab);
+        }));
+
+        results.push_back(measure("add", count, repeat, withEntities, [](EcsDirector &director, world &state) {
+            for (const ecs::entity entity : state.entities) { director.addComponent(entity, Position()); }
+        }));
+
+        results.push_back(measure("get", count, repeat, populated, [](EcsDirector &director, world &state) {
+            float sum = 0.f;
+            for (const ecs::entity entity : state.entities) { sum += director.getComponent<const Position>(entity).x; }
+
+            // Stops the loop from being optimised away.
+            volatile float sink = sum;
+            static_cast<void>(sink);
+        }));
+
+        results.push_back(measure("iterate", count, repeat, populated, [](EcsDirector &, world &state) {
+            state.moveSystem->run();
+        }));
+
+        results.push_back(measure("remove", count, repeat, populated, [](EcsDirector &director, world &state) {
+            for (const ecs::entity entity : state.entities) { director.removeComponent<Velocity>(entity); }
+        }));
+
+        results.push_back(measure("destroy", count, repeat, populated, [](EcsDirector &director, world &state) {
+            for (const ecs::entity entity : state.entities) { director.destroyEntity(entity); }
+        }));
+
+        const auto churnSetup = [count](EcsDirector &director) {
+            world state = makePopulated(director, count);
+            registerTags(director, std::make_integer_sequence<int, tagCount>());
+            registerChurnSystems(director, std::make_integer_sequence<int, churnSystemCount>());
+            return state;
+        };
+        results.push_back(measure("signatureChurn", count, repeat, churnSetup, [](EcsDirector &director, world &state) {
+            for (const ecs::entity entity : state.entities)
+            {
+                toggleTags(director, entity, std::make_integer_sequence<int, tagCount>());
+            }
+        }));
+
+        return results;
+    }
+
+    std::string toJson(const std::vector<result> &results, int repeat)
+    {
+        std::stringstream ss;
+        ss << "{\n";
+        ss << "  \"repeat\": " << repeat << ",\n";
+#ifdef NDEBUG
+        ss << "  \"optimised\": true,\n";
+#else
+        ss << "  \"optimised\": false,\n";
+#endif
+        ss << "  \"churnSystems\": " << churnSystemCount << ",\n";
+        ss << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const result &r = results[i];
+            ss << "    { \"name\": \"" << r.name << "\", \"entities\": " << r.entities
+               << ", \"bestMs\": " << r.bestMs << ", \"medianMs\": " << r.medianMs
+               << ", \"nsPerEntity\": " << r.bestMs * 1'000'000.0 / static_cast<double>(r.entities) << " }"
+               << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        ss << "  ]\n";
+        ss << "}\n";
+        return ss.str();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int repeat = 5;
+    size_t maxEntities = 1'000'000;
+    std::string outPath;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--repeat")      { repeat = std::max(1, std::atoi(argv[i + 1])); }
+        else if (arg == "--max")    { maxEntities = std::strtoull(argv[i + 1], nullptr, 10); }
+        else if (arg == "--out")    { outPath = argv[i + 1]; }
+        else
+        {
+            std::cerr << "Unknown argument " << arg << ". Usage: ecs_bench [--repeat n] [--max entities] [--out file]\n";
+            return 1;
+        }
+    }
+
+    std::vector<bench::result> results;
+    for (const size_t count : { 1'000, 10'000, 100'000, 1'000'000 })
+    {
+        if (count > maxEntities) { break; }
+        auto sizeResults = bench::run(count, repeat);
+        results.insert(results.end(), sizeResults.begin(), sizeResults.end());
+    }
+
+    const std::string json = bench::toJson(results, repeat);
+    std::cout << json;
+    if (!outPath.empty())
+    {
+        std::ofstream file(outPath, std::ios_base::trunc);
+        file << json;
+    }
+    return 0;
+}
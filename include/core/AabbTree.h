@@ -0,0 +1,232 @@
+#pragma once
+
+#include <glm.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * A bounding volume hierarchy that boxes can be inserted into, moved around in and removed from one at a time.
+ * Leaves are fattened by a margin so that small movements don't touch the tree. Larger ones refit the leaf's
+ * ancestors, and every node that is refitted tries a rotation that shrinks the surface area below it. Trees that
+ * rarely change can be rebuilt from scratch with a binned surface area heuristic (SAH) instead.
+ * @example tree.queryFrustum(planes, [](uint64_t userData) { ... });
+ * @author Ryan Purse
+ */
+class AabbTree
+{
+public:
+    static constexpr int nullNode { -1 };
+
+    struct aabb
+    {
+        glm::vec3 min { 0.f };
+        glm::vec3 max { 0.f };
+    };
+
+    /** @param margin How far each leaf is grown in every direction. */
+    explicit AabbTree(float margin=0.1f);
+
+    /** @return A proxy that refers to the box until it is removed. */
+    int insert(const aabb &box, uint64_t userData);
+
+    /**
+     * Adds a box without placing it in the tree, which is much faster when many boxes are added at once. Queries
+     * won't find it until the next rebuild().
+     */
+    int insertUnlinked(const aabb &box, uint64_t userData);
+
+    void remove(int proxy);
+
+    /**
+     * Moves a proxy's box. Moves that stay close to the old box refit the tree in place. Others remove the leaf
+     * and insert it again.
+     * @return False if the box still fits inside its fattened box, so nothing changed.
+     */
+    bool move(int proxy, const aabb &box);
+
+    /** Builds the whole tree again with a binned SAH. Much slower than insert() but gives a better tree. */
+    void rebuild();
+
+    void clear();
+
+    [[nodiscard]] uint64_t getUserData(int proxy) const { return mNodes[proxy].userData; }
+    [[nodiscard]] const aabb &getFatBox(int proxy) const { return mNodes[proxy].box; }
+    [[nodiscard]] size_t size() const { return mLeafCount; }
+    [[nodiscard]] int getHeight() const { return mRoot == nullNode ? 0 : mNodes[mRoot].height; }
+
+    /** @return The surface area of every internal node over the root's. Lower means that queries visit less. */
+    [[nodiscard]] float getAreaRatio() const;
+
+    // Each query calls func(userData) for every leaf whose fattened box passes the test.
+    template<typename Func>
+    void queryAabb(const aabb &box, Func &&func) const
+    {
+        query([&box](const aabb &nodeBox) { return overlaps(nodeBox, box); }, func);
+    }
+
+    template<typename Func>
+    void querySphere(const glm::vec3 &centre, float radius, Func &&func) const
+    {
+        query([&centre, radius](const aabb &nodeBox) {
+            const glm::vec3 offset = glm::clamp(centre, nodeBox.min, nodeBox.max) - centre;
+            return glm::dot(offset, offset) <= radius * radius;
+        }, func);
+    }
+
+    /** @param planes Planes whose normals point inwards, such as from FrustumCuller::extractPlanes(). */
+    template<typename Func>
+    void queryFrustum(const std::array<glm::vec4, 6> &planes, Func &&func) const;
+
+    /** @param direction Doesn't need to be normalised. maxDistance is measured in multiples of it. */
+    template<typename Func>
+    void raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, Func &&func) const
+    {
+        const glm::vec3 inverse = 1.f / direction;
+        query([&origin, &inverse, maxDistance](const aabb &nodeBox) {
+            const glm::vec3 t1 = (nodeBox.min - origin) * inverse;
+            const glm::vec3 t2 = (nodeBox.max - origin) * inverse;
+            const glm::vec3 tNear = glm::min(t1, t2);
+            const glm::vec3 tFar = glm::max(t1, t2);
+            const float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.f));
+            const float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+            return enter <= exit;
+        }, func);
+    }
+
+    static aabb combine(const aabb &lhs, const aabb &rhs) { return { glm::min(lhs.min, rhs.min), glm::max(lhs.max, rhs.max) }; }
+    static bool overlaps(const aabb &lhs, const aabb &rhs);
+    static bool contains(const aabb &outer, const aabb &inner);
+
+    /** @return Half of the box's surface area, which is all that the SAH needs to compare boxes. */
+    static float area(const aabb &box);
+
+protected:
+    struct node
+    {
+        aabb box;
+        uint64_t userData   { 0 };
+        int parent          { nullNode };  // The next free node while this one is unused.
+        int child1          { nullNode };
+        int child2          { nullNode };
+        int height          { 0 };         // Zero for leaves and -1 for unused nodes.
+
+        [[nodiscard]] bool isLeaf() const { return child1 == nullNode; }
+    };
+
+    /** A traversal stack that only allocates if the tree is deeper than expected. */
+    class nodeStack
+    {
+    public:
+        void push(int index)
+        {
+            if (mSize < mFixed.size()) { mFixed[mSize++] = index; }
+            else { mOverflow.push_back(index); }
+        }
+
+        int pop()
+        {
+            if (mOverflow.empty()) { return mFixed[--mSize]; }
+            const int index = mOverflow.back();
+            mOverflow.pop_back();
+            return index;
+        }
+
+        [[nodiscard]] bool empty() const { return mSize == 0; }
+
+    private:
+        std::array<int, 128> mFixed;
+        size_t mSize { 0 };
+        std::vector<int> mOverflow;
+    };
+
+    /** Calls func(userData) for every leaf that can be reached through nodes that pass test. */
+    template<typename Test, typename Func>
+    void query(Test &&test, Func &&func) const
+    {
+        if (mRoot == nullNode) { return; }
+        nodeStack stack;
+        stack.push(mRoot);
+        while (!stack.empty())
+        {
+            const node &current = mNodes[stack.pop()];
+            if (!test(current.box)) { continue; }
+            if (current.isLeaf()) { func(current.userData); }
+            else
+            {
+                stack.push(current.child1);
+                stack.push(current.child2);
+            }
+        }
+    }
+
+    int allocateNode();
+    void freeNode(int index);
+
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+
+    /** Rotates and then refits every node from index up to the root. */
+    void refitUpwards(int index);
+
+    /** Swaps a child of the node with a grandchild on the other side if that shrinks the other child. */
+    void rotate(int index);
+
+    /** A leaf's box is copied in so that building doesn't have to jump around mNodes. */
+    struct buildItem
+    {
+        aabb box;
+        glm::vec3 centre;
+        int leaf;
+    };
+
+    /** @return The root of a SAH tree built over the items. The items are reordered. */
+    int buildRange(buildItem *items, size_t count, int parent);
+
+    std::vector<node> mNodes;
+    int mRoot       { nullNode };
+    int mFreeList   { nullNode };
+    size_t mLeafCount { 0 };
+    float mMargin;
+};
+
+template<typename Func>
+void AabbTree::queryFrustum(const std::array<glm::vec4, 6> &planes, Func &&func) const
+{
+    if (mRoot == nullNode) { return; }
+
+    // Entries with a set high bit are inside of every plane, so everything below them is visible without a test.
+    constexpr unsigned int insideBit = 1u << 31;
+    nodeStack stack;
+    stack.push(mRoot);
+    while (!stack.empty())
+    {
+        const auto entry = static_cast<unsigned int>(stack.pop());
+        const node &current = mNodes[entry & ~insideBit];
+        bool inside = (entry & insideBit) != 0;
+        if (!inside)
+        {
+            inside = true;
+            bool outside = false;
+            for (const glm::vec4 &plane : planes)
+            {
+                const glm::vec3 normal(plane);
+                const glm::vec3 furthest = glm::mix(current.box.min, current.box.max, glm::greaterThan(normal, glm::vec3(0.f)));
+                const glm::vec3 nearest = glm::mix(current.box.max, current.box.min, glm::greaterThan(normal, glm::vec3(0.f)));
+                if (glm::dot(normal, furthest) + plane.w < 0.f) { outside = true; break; }
+                if (glm::dot(normal, nearest) + plane.w < 0.f) { inside = false; }
+            }
+            if (outside) { continue; }
+        }
+
+        if (current.isLeaf()) { func(current.userData); }
+        else
+        {
+            const unsigned int flag = inside ? insideBit : 0u;
+            stack.push(static_cast<int>(static_cast<unsigned int>(current.child1) | flag));
+            stack.push(static_cast<int>(static_cast<unsigned int>(current.child2) | flag));
+        }
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "System.h"
+#include "Components.h"
 
 #include <glfw3.h>
 
@@ -12,7 +13,7 @@ class CameraControllerSystem : public System
 {
 public:
     CameraControllerSystem();
-    void update(float tickRate);
+    void update(float tickRate) override;
     void moveFirstPerson(float tickRate);
 protected:
     GLFWwindow *mWindow;
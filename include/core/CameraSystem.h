@@ -1,6 +1,7 @@
 #pragma once
 
 #include "System.h"
+#include "Components.h"
 
 /**
  * Creates view matrices out of camera transforms.
@@ -10,7 +11,7 @@ class CameraSystem : public System
 {
 public:
     void init();
-    void update();
+    void update(float deltaTime) override;
 protected:
 
 };
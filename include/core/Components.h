@@ -10,9 +10,11 @@
 #pragma once
 
 #include "Vertex.h"
+#include "EcsCommon.h"
 
 #include <glm.hpp>
 #include <gtx/quaternion.hpp>
+#include <limits>
 #include <utility>
 #include <vector>
 #include <string>
@@ -24,12 +26,57 @@ struct Transform
     glm::vec3 scale     { 1.f };
 };
 
+/** Makes an entity's Transform relative to another entity. Set through hierarchy::setParent() so Children stays in sync. */
+struct Parent
+{
+    ecs::entity entity { ecs::invalidId };
+};
+
+struct Children
+{
+    std::vector<ecs::entity> entities;
+};
+
+/** The Transform combined with every parent's. Written by the TransformSystem. */
+struct WorldTransform
+{
+    glm::mat4 matrix { 1.f };
+};
+
 struct PolygonalMesh
 {
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
 };
 
+/** A mesh's bounding box and sphere in its local space. Found once when the mesh is loaded. */
+struct Bounds
+{
+    glm::vec3 min       { 0.f };
+    glm::vec3 max       { 0.f };
+    glm::vec3 centre    { 0.f };
+    float radius        { 0.f };
+};
+
+/** Refers to a mesh owned by a MeshRegistry. Many entities can share the same mesh. */
+struct MeshHandle
+{
+    static constexpr unsigned int invalidId { std::numeric_limits<unsigned int>::max() };
+    unsigned int id { invalidId };
+
+    [[nodiscard]] bool isValid() const { return id != invalidId; }
+    bool operator==(const MeshHandle &other) const { return id == other.id; }
+};
+
+/**
+ * Marks an entity as hiding the entities behind it from the occlusion culler. mesh can be a simplified stand in,
+ * which must fit inside of the real one. The entity's own MeshHandle is used if it isn't valid.
+ */
+struct Occluder
+{
+    MeshHandle mesh;
+};
+
 struct CameraMatrices
 {
     glm::mat4 vpMatrix          { 1.f };
@@ -54,9 +101,7 @@ struct CameraController
 
 struct RendererUniforms
 {
-    glm::mat4 mvp           { 1.f };
-    glm::mat4 modelMat { 1.f };
-    std::vector <unsigned int> materialIds{};  // Not related to the uv index in vertices.
+    std::vector <unsigned int> materialIds{};  // Not related to the uv index in vertices. Must be consecutive.
     unsigned int diffuseTexturesId { 0 };
     unsigned int normalMapId { 0 };
 };
@@ -69,6 +114,7 @@ struct Material  // Materials are not needed for rendering. RenderUniforms are h
     glm::vec3 kSpecular         { 1.f };
     float nSpecular             { 225 };
     unsigned int normalMapIndex { 0 };
+    float dissolve              { 1.f };  // The .mtl's d value. Anything below one is drawn in the transparent pass.
 };
 
 struct MaterialTexture
@@ -9,7 +9,9 @@
 
 #pragma once
 
+#include <exception>
 #include <source_location>
+#include <string_view>
 
 namespace debug
 {
@@ -44,8 +46,14 @@ namespace debug
      */
     void log(const unsigned char *message, severity level);
 
-    /** Call back to attach to opengl when in debug mode. */
-    void openglCallBack(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *message, const void *userParam);
+    /**
+     * Outputs an already formatted message, force crashing if the severity level is above a threshold.
+     * Used by loggers that have their own layout, such as the OpenGL callback.
+     */
+    void logFormatted(std::string_view output, severity level);
+
+    /** @return The name of a severity level. */
+    [[nodiscard]] std::string_view toString(severity level);
 
     /** Clears the log file. */
     void clearLogs();
@@ -53,7 +61,7 @@ namespace debug
     /** Used when a log exception occurs. */
     class LogException : std::exception
     {
-        [[nodiscard]] const char *what() const override
+        [[nodiscard]] const char *what() const noexcept override
         {
             return "Log message exceed the maximum throw level threshold. Check the logs for more information.";
         }
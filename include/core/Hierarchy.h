@@ -0,0 +1,24 @@
+/**
+ * @file Hierarchy.h
+ * @brief Attaches entities to each other so that they move together.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+
+#pragma once
+
+#include "EcsDirector.h"
+
+namespace hierarchy
+{
+    /**
+     * Makes child's Transform relative to parent's. Keeps the child's Parent and the parent's Children in sync.
+     * Parenting an entity to one of its own descendants is logged and ignored.
+     */
+    void setParent(EcsDirector &director, ecs::entity child, ecs::entity parent);
+
+    /** Moves child back to the root. Its Transform is left as it is and so becomes relative to the world. */
+    void removeParent(EcsDirector &director, ecs::entity child);
+}
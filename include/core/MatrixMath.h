@@ -0,0 +1,60 @@
+/**
+ * @file MatrixMath.h
+ * @brief Matrix operations that are run often enough to be worth hand vectorising.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+
+#pragma once
+
+#include <glm.hpp>
+#include <gtx/quaternion.hpp>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define MATRIX_MATH_SSE
+    #include <xmmintrin.h>
+#endif
+
+namespace math
+{
+    /** @return lhs * rhs. Each column of the result is four multiply-adds of lhs's columns. */
+    inline glm::mat4 multiply(const glm::mat4 &lhs, const glm::mat4 &rhs)
+    {
+#ifdef MATRIX_MATH_SSE
+        const float *a = &lhs[0][0];
+        const float *b = &rhs[0][0];
+        const __m128 a0 = _mm_loadu_ps(a);
+        const __m128 a1 = _mm_loadu_ps(a + 4);
+        const __m128 a2 = _mm_loadu_ps(a + 8);
+        const __m128 a3 = _mm_loadu_ps(a + 12);
+
+        glm::mat4 result;
+        float *out = &result[0][0];
+        for (int column = 0; column < 4; ++column)
+        {
+            const float *bColumn = b + column * 4;
+            __m128 sum = _mm_mul_ps(a0, _mm_set1_ps(bColumn[0]));
+            sum = _mm_add_ps(sum, _mm_mul_ps(a1, _mm_set1_ps(bColumn[1])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(a2, _mm_set1_ps(bColumn[2])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(a3, _mm_set1_ps(bColumn[3])));
+            _mm_storeu_ps(out + column * 4, sum);
+        }
+        return result;
+#else
+        return lhs * rhs;
+#endif
+    }
+
+    /** @return translation * rotation * scale, built directly instead of multiplying three matrices. */
+    inline glm::mat4 compose(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale)
+    {
+        glm::mat4 result = glm::toMat4(rotation);
+        result[0] *= scale.x;
+        result[1] *= scale.y;
+        result[2] *= scale.z;
+        result[3] = glm::vec4(position, 1.f);
+        return result;
+    }
+}
@@ -0,0 +1,19 @@
+/**
+ * @file OpenGlLogger.h
+ * @brief Forwards OpenGL debug messages to the debug logger. Kept apart from DebugLogger so that code which
+ * doesn't use OpenGL, such as the ECS, can log without it.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+
+#pragma once
+
+#include <glew.h>
+
+namespace debug
+{
+    /** Call back to attach to opengl when in debug mode. */
+    void openglCallBack(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *message, const void *userParam);
+}
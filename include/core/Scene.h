@@ -4,6 +4,8 @@
 #include "CameraControllerSystem.h"
 #include "CameraSystem.h"
 #include "TextureSystem.h"
+#include "TransformSystem.h"
+#include "SpatialSystem.h"
 #include "EcsCommon.h"
 #include "EcsDirector.h"
 
@@ -19,17 +21,30 @@ class Scene
 public:
     Scene();
     virtual void update(float deltaTime);
-    virtual void render();
+    /** @param resolution The size of the window's framebuffer in pixels. */
+    virtual void render(const glm::ivec2 &resolution);
     virtual void renderImGui();
 
 protected:
     void registerComponents();
+    void registerSerializers();
     void registerSystems();
     void registerEntities();
 
+    /** Gives an entity a model's mesh and materials. Models that have already been loaded are reused. */
+    void addModel(ecs::entity entity, std::string_view path);
+
+    /** Mesh handles are only valid in this run, so snapshots store the mesh's source instead. */
+    void writeMesh(SnapshotWriter &writer, MeshHandle mesh) const;
+
+    /** @return The mesh with the source that writeMesh() wrote. It is loaded or rebuilt if this run hasn't yet. */
+    MeshHandle readMesh(SnapshotReader &reader);
+
     EcsDirector mDirector;
     ecs::entity mMainCamera{};
     ecs::entity mLight;
+    std::shared_ptr<TransformSystem> mTransformSystem;
+    std::shared_ptr<SpatialSystem> mSpatialSystem;
     std::shared_ptr<RendererSystem> mRendererSystem;
     std::shared_ptr<CameraSystem> mCameraSystem;
     std::shared_ptr<CameraControllerSystem> mCameraControllerSystem;
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "System.h"
+#include "Components.h"
+#include "AabbTree.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Keeps the world space box of every entity with Bounds in an AabbTree so that spatial queries don't have to look
+ * at every entity. Entities start out in a static tree that is rebuilt with the SAH. Once one moves, it is kept in
+ * a dynamic tree that is updated in place, and goes back to the static tree after it has been still for a while.
+ * @author Ryan Purse
+ */
+class SpatialSystem : public System
+{
+public:
+    /** The number of updates that an entity has to stay still for before it goes back to the static tree. */
+    static constexpr uint32_t settleUpdates { 60 };
+
+    void update(float deltaTime) override;
+
+    // Each query calls func(entity) for every entity whose fattened box passes the test.
+    template<typename Func>
+    void queryFrustum(const std::array<glm::vec4, 6> &planes, Func &&func) const
+    {
+        const auto visit = [&func](uint64_t userData) { func(static_cast<ecs::entity>(userData)); };
+        mStaticTree.queryFrustum(planes, visit);
+        mDynamicTree.queryFrustum(planes, visit);
+    }
+
+    template<typename Func>
+    void querySphere(const glm::vec3 &centre, float radius, Func &&func) const
+    {
+        const auto visit = [&func](uint64_t userData) { func(static_cast<ecs::entity>(userData)); };
+        mStaticTree.querySphere(centre, radius, visit);
+        mDynamicTree.querySphere(centre, radius, visit);
+    }
+
+    template<typename Func>
+    void queryAabb(const AabbTree::aabb &box, Func &&func) const
+    {
+        const auto visit = [&func](uint64_t userData) { func(static_cast<ecs::entity>(userData)); };
+        mStaticTree.queryAabb(box, visit);
+        mDynamicTree.queryAabb(box, visit);
+    }
+
+    template<typename Func>
+    void raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, Func &&func) const
+    {
+        const auto visit = [&func](uint64_t userData) { func(static_cast<ecs::entity>(userData)); };
+        mStaticTree.raycast(origin, direction, maxDistance, visit);
+        mDynamicTree.raycast(origin, direction, maxDistance, visit);
+    }
+
+    /** @return The bounds moved into world space. The box covers the transformed local box. */
+    static AabbTree::aabb toWorld(const Bounds &bounds, const glm::mat4 &world);
+
+    [[nodiscard]] const AabbTree &getStaticTree() const { return mStaticTree; }
+    [[nodiscard]] const AabbTree &getDynamicTree() const { return mDynamicTree; }
+
+protected:
+    enum class treeKind : uint8_t { None, Static, Dynamic };
+
+    /** Where an entity is in the trees. Indexed by the entity's index. */
+    struct record
+    {
+        ecs::entity entity      { ecs::invalidId };
+        int proxy               { AabbTree::nullNode };
+        treeKind tree           { treeKind::None };
+        uint32_t lastMoved      { 0 };
+    };
+
+    record &getRecord(ecs::entity entity);
+
+    /** @param linked Set to false when a rebuild will follow anyway, so the tree is left alone until then. */
+    void insertStatic(record &entry, const AabbTree::aabb &box, bool linked=true);
+    void untrack(record &entry);
+
+    /** Adds entities that joined the system and removes the ones that left. */
+    void reconcileEntities();
+
+    /** Moves entities that have been still for settleUpdates back to the static tree. */
+    void settleDynamic();
+
+    /** @return How many boxes can be inserted into the static tree before it is worth rebuilding. */
+    [[nodiscard]] size_t getRebuildThreshold() const { return std::max<size_t>(64, mStaticTree.size() / 16); }
+
+    std::vector<record> mRecords;
+    std::vector<ecs::entity> mDynamicEntities;
+    AabbTree mStaticTree;
+    AabbTree mDynamicTree;
+    size_t mStaticInsertsSinceRebuild { 0 };
+    bool mStaticHasUnlinked { false };
+    uint32_t mUpdate { 0 };
+    uint64_t mEntitiesVersion { std::numeric_limits<uint64_t>::max() };
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "System.h"
+#include "Components.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Turns Transforms into WorldTransforms. Entities are kept in a dense array sorted by depth so that every parent
+ * is finished before its children are reached, and a single pass in order covers the whole hierarchy.
+ * Only entities whose Transform changed, and everything below them, are recomputed.
+ * @author Ryan Purse
+ */
+class TransformSystem : public System
+{
+    typedef uint32_t slot;
+    static constexpr slot noParent = std::numeric_limits<slot>::max();
+public:
+    void update(float deltaTime) override;
+
+protected:
+    /** Sorts the entities by depth. Run whenever an entity joins or leaves or a Parent changes. */
+    void rebuildOrder();
+
+    /** @param all Recomputes every entity instead of only the changed ones. */
+    void propagate(bool all);
+
+    std::vector<ecs::entity> mOrder;        // Sorted by depth so parents always come before their children.
+    std::vector<slot> mParents;             // Slot of each entity's parent in mOrder, or noParent for roots.
+    std::vector<glm::mat4> mWorldMatrices;  // Read back by children. Kept here so the reads are contiguous.
+    std::vector<uint8_t> mDirty;
+    uint64_t mEntitiesVersion { std::numeric_limits<uint64_t>::max() };
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "EcsCommon.h"
+#include "ComponentManager.h"
+
+#include <functional>
+#include <vector>
+
+/**
+ * Records structural changes (creating/destroying entities and adding/removing components) so that they can be
+ * played back later in one batch. Each thread gets its own buffer, so recording never needs a lock.
+ * Get one from System::getCommandBuffer() or EcsDirector::getCommandBuffer().
+ * @author Ryan Purse
+ */
+class CommandBuffer
+{
+    friend class CommandManager;
+public:
+    /**
+     * Reserves an entity. The handle that is returned can be used with this buffer and is swapped for a real
+     * entity when the buffer is played back.
+     */
+    ecs::entity createEntity()
+    {
+        return ecs::makeEntity(mPlaceholderCount++, ecs::placeholderGeneration);
+    }
+
+    void destroyEntity(ecs::entity entity)
+    {
+        mCommands.push_back({ entity, commandType::Destroy, ecs::invalidId, {} });
+    }
+
+    template<typename Component>
+    void addComponent(ecs::entity entity, Component component)
+    {
+        // Commands are only played back once, so the component can be moved out of the buffer.
+        mCommands.push_back({
+            entity, commandType::Add, ecs::typeIndex<ecs::componentFamily, Component>,
+            [component = std::move(component)](ComponentManager &componentManager, ecs::entity target) mutable {
+                componentManager.addComponent(target, std::move(component));
+            }
+        });
+    }
+
+    template<typename Component>
+    void removeComponent(ecs::entity entity)
+    {
+        mCommands.push_back({
+            entity, commandType::Remove, ecs::typeIndex<ecs::componentFamily, Component>,
+            [](ComponentManager &componentManager, ecs::entity target) {
+                componentManager.removeComponent<Component>(target);
+            }
+        });
+    }
+
+    [[nodiscard]] bool empty() const { return mCommands.empty() && mPlaceholderCount == 0; }
+    [[nodiscard]] size_t size() const { return mCommands.size(); }
+
+protected:
+    enum class commandType : unsigned char { Add, Remove, Destroy };
+
+    struct command
+    {
+        ecs::entity entity;
+        commandType type;
+        ecs::componentId componentId;
+        std::function<void(ComponentManager &, ecs::entity)> apply;
+    };
+
+    void clear()
+    {
+        mCommands.clear();
+        mPlaceholderCount = 0;
+    }
+
+    std::vector<command> mCommands;
+    ecs::entityIndex mPlaceholderCount { 0 };
+};
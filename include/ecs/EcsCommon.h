@@ -10,17 +10,89 @@
 #pragma once
 
 #include <bitset>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <typeinfo>
 
 namespace ecs
 {
-    typedef size_t entity;
-    const size_t maxEntities = 5'000;
+    /**
+     * Entities are handles. The lower 32 bits are an index into the entity storage and the upper 32 bits are a
+     * generation that is bumped every time the index is recycled. Handles to destroyed entities can therefore be
+     * detected, even after their index has been reused.
+     */
+    typedef uint64_t entity;
+    typedef uint32_t entityIndex;
+    typedef uint32_t entityGeneration;
+
+    // Storage grows on demand up to this many entity slots.
+    const size_t maxEntities = 16'777'216;
+
+    inline entityIndex indexOf(entity handle) { return static_cast<entityIndex>(handle & 0xFFFF'FFFF); }
+    inline entityGeneration generationOf(entity handle) { return static_cast<entityGeneration>(handle >> 32); }
+    inline entity makeEntity(entityIndex index, entityGeneration generation)
+    {
+        return (static_cast<entity>(generation) << 32) | index;
+    }
+
+    // Marks an entity that a command buffer has promised to create but has not been played back yet.
+    const entityGeneration placeholderGeneration = std::numeric_limits<entityGeneration>::max();
+
+    inline bool isPlaceholder(entity handle) { return generationOf(handle) == placeholderGeneration; }
 
     typedef size_t componentId;
     const size_t maxComponents = 32;
 
+    typedef size_t systemId;
+
+    /**
+     * A point in time that a component was last written to. Every system run and structural change takes a new
+     * tick, so comparing against the tick a system last ran at tells it what has changed since. 64 bits is
+     * enough that it never wraps.
+     */
+    typedef uint64_t tick;
+
+    const size_t cacheLineSize = 64;
+
     typedef std::bitset<maxComponents> signature;
 
+    const size_t invalidId = std::numeric_limits<size_t>::max();
+
+    /** Tags used to number components and systems separately. */
+    struct componentFamily {};
+    struct systemFamily {};
+
+    /**
+     * The static index of type T within Family. It is invalidId until the type has been registered.
+     * Reading it is a single load, so it can be used to index straight into a flat array.
+     */
+    template<typename Family, typename T>
+    inline size_t typeIndex = invalidId;
+
+    template<typename Family>
+    inline size_t nextTypeIndex = 0;
+
+    /**
+     * Gives T the next free index in Family the first time it is called. The same index is returned afterwards.
+     */
+    template<typename Family, typename T>
+    size_t assignTypeIndex()
+    {
+        if (typeIndex<Family, T> == invalidId) { typeIndex<Family, T> = nextTypeIndex<Family>++; }
+        return typeIndex<Family, T>;
+    }
+
+    /** Lists of components that a system reads from or writes to. Used by the scheduler to find conflicts. */
+    template<typename... Components>
+    struct read {};
+
+    template<typename... Components>
+    struct write {};
+
+    /** Where a system is allowed to run. Systems that talk to the window or OpenGL must stay on the main thread. */
+    enum class thread : unsigned char { Any, Main };
+
     template<typename Component>
     std::string toString()
     {
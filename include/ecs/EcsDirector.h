@@ -1,10 +1,18 @@
 #pragma once
 
 #include "EcsCommon.h"
+#include "DebugLogger.h"
 #include "EntityManager.h"
 #include "SystemManager.h"
 #include "ComponentManager.h"
-#include "Loader.h"
+#include "Scheduler.h"
+#include "CommandManager.h"
+#include "Prefab.h"
+#include "Snapshot.h"
+#include "ThreadPool.h"
+
+#include <string_view>
+#include <unordered_map>
 
 
 /**
@@ -27,6 +35,39 @@ public:
         mSystemManager.entityDestroyed(entity);
     }
 
+    /**
+     * Creates count entities that each get a copy of the prefab's components. Storage for each component is
+     * grown once and systems are notified in a single pass.
+     */
+    std::vector<ecs::entity> createEntities(size_t count, const Prefab &prefab)
+    {
+        return createFromPrefab(count, prefab, ecs::invalidId);
+    }
+
+    /**
+     * Creates an entity for each element of components. Every entity gets a copy of the prefab's components
+     * plus its own element, which replaces the prefab's copy if the prefab also has a Component.
+     * @example instantiate(rockPrefab, rockTransforms);
+     */
+    template<typename Component>
+    std::vector<ecs::entity> instantiate(const Prefab &prefab, const std::vector<Component> &components)
+    {
+        const ecs::componentId id = getComponentId<Component>();
+        auto entities = createFromPrefab(components.size(), prefab, id, false);
+        mComponentManager.addComponents(entities.data(), std::span<const Component>(components));
+
+        const auto signature = getSignature(prefab).set(id);
+        mEntityManager.setSignature(entities.data(), entities.size(), signature);
+        mSystemManager.entitySignatureChanged(entities.data(), entities.size(), signature);
+        return entities;
+    }
+
+    /** @return False if the entity was never created or has been destroyed, even if its index was reused. */
+    [[nodiscard]] bool isAlive(ecs::entity entity) const
+    {
+        return mEntityManager.isAlive(entity);
+    }
+
     // Component Methods //
     template<typename Component>
     void registerComponent()
@@ -34,25 +75,51 @@ public:
         mComponentManager.registerComponent<Component>();
     }
 
+    /**
+     * Sets how a component is written to and read from snapshots. Components that are not trivially copyable,
+     * such as ones holding vectors, are left out of snapshots until they have one.
+     * @example registerSerializer<PolygonalMesh>(
+     *     [](SnapshotWriter &writer, const PolygonalMesh &mesh) { writer.write(mesh.vertices); ... },
+     *     [](SnapshotReader &reader, PolygonalMesh &mesh) { reader.read(mesh.vertices); ... });
+     */
     template<typename Component>
-    void addComponent(ecs::entity entity, Component component)
+    void registerSerializer(typename ComponentArray<Component>::writeFunction write,
+                            typename ComponentArray<Component>::readFunction read)
     {
-        mComponentManager.addComponent(entity, component);
-        auto signature = mEntityManager.getSignature(entity);
-        signature.set(mComponentManager.getComponentId<Component>());
-        mEntityManager.setSignature(entity, signature);
-        mSystemManager.entitySignatureChanged(entity, signature);
+        mComponentManager.setSerializer<Component>(std::move(write), std::move(read));
+    }
+
+    /** Temporaries are moved all the way into storage, so adding a large component never copies it. */
+    template<typename Component>
+    void addComponent(ecs::entity entity, Component &&component)
+    {
+        mComponentManager.addComponent(entity, std::forward<Component>(component));
+        componentAdded<std::remove_cvref_t<Component>>(entity);
     }
 
-    template<>
-    void addComponent<ModelData>(ecs::entity entity, ModelData component)
+    /**
+     * Constructs a component in place from args.
+     * @example emplaceComponent<Transform>(entity, glm::vec3(1.f), glm::quat(), glm::vec3(1.f));
+     */
+    template<typename Component, typename... Args>
+    Component &emplaceComponent(ecs::entity entity, Args &&...args)
     {
-        auto &[mesh, materials, matTextures] = component;
-        if (mesh.vertices.empty()) { return; }  // Object failed to load.
-        addComponent(entity, mesh);
-        addComponent(entity, RendererUniforms());
-        addComponent(entity, materials);
-        addComponent(entity, matTextures);
+        Component &component = mComponentManager.emplaceComponent<Component>(entity, std::forward<Args>(args)...);
+        componentAdded<Component>(entity);
+        return component;
+    }
+
+    /**
+     * Adds several components to an entity at once. Systems are only notified once all of them have been added.
+     */
+    template<typename... Components>
+    void addComponents(ecs::entity entity, Components &&...components)
+    {
+        (mComponentManager.addComponent(entity, std::forward<Components>(components)), ...);
+        const auto signature = mEntityManager.getSignature(entity)
+                | getSignature<std::remove_cvref_t<Components>...>();
+        mEntityManager.setSignature(entity, signature);
+        mSystemManager.entitySignatureChanged(entity, signature);
     }
 
     template<typename Component>
@@ -65,6 +132,13 @@ public:
         mSystemManager.entitySignatureChanged(entity, signature);
     }
 
+    template<typename Component>
+    [[nodiscard]] bool hasComponent(ecs::entity entity)
+    {
+        return mComponentManager.hasComponent<Component>(entity);
+    }
+
+    /** Use a const Component for read only access. Otherwise every system will see the component as changed. */
     template<typename Component>
     Component &getComponent(ecs::entity entity)
     {
@@ -77,12 +151,23 @@ public:
         return mComponentManager.getComponentId<Component>();
     }
 
+    /** Builds a signature out of a list of components. */
+    template<typename... Components>
+    ecs::signature getSignature()
+    {
+        ecs::signature signature;
+        (signature.set(getComponentId<Components>()), ...);
+        return signature;
+    }
+
     // System Methods //
     template<typename sys>
     std::shared_ptr<sys> registerSystem()
     {
         auto system = mSystemManager.registerSystem<sys>();
         system->mComponentManager = &mComponentManager;
+        system->mThreadPool = &mThreadPool;
+        system->mCommandManager = &mCommandManager;
         return system;
     }
 
@@ -92,10 +177,143 @@ public:
         mSystemManager.setSignature<sys>(signature);
     }
 
+    /** Sets the signature of a system from the list of components that it uses. */
+    template<typename sys, typename... Components>
+    void setSystemSignature()
+    {
+        mSystemManager.setSignature<sys>(getSignature<Components...>());
+    }
+
+    // Scheduling Methods //
+    /**
+     * Adds a system to the update schedule. Systems that touch the same components, where at least one of them
+     * writes to it, are updated in the order that they were scheduled. All others may run at the same time.
+     * @example scheduleSystem<CameraSystem>(ecs::read<Camera, Transform>(), ecs::write<CameraMatrices>());
+     */
+    template<typename sys, typename... Reads, typename... Writes>
+    void scheduleSystem(ecs::read<Reads...>, ecs::write<Writes...>, ecs::thread affinity=ecs::thread::Any)
+    {
+        mScheduler.add(mSystemManager.getSystem<sys>(), ecs::toString<sys>(),
+                       getSignature<Reads...>(), getSignature<Writes...>(), affinity);
+    }
+
+    /** Updates every scheduled system once and then applies any structural changes that they recorded. */
+    void update(float deltaTime)
+    {
+        mScheduler.run(deltaTime, mThreadPool);
+        flushCommands();
+    }
+
+    // Command Methods //
+    /**
+     * @return The calling thread's command buffer. The create, add, remove and destroy methods above take effect
+     * immediately and so must not be used while a system is iterating or from another thread. Record them here
+     * instead.
+     */
+    CommandBuffer &getCommandBuffer()
+    {
+        return mCommandManager.getCommandBuffer();
+    }
+
+    /** Plays back every thread's command buffer in a single batch. */
+    void flushCommands()
+    {
+        mCommandManager.flush(mEntityManager, mComponentManager, mSystemManager);
+    }
+
+    [[nodiscard]] const Scheduler &getScheduler() const { return mScheduler; }
+
+    // Snapshot Methods //
+    /** Writes every entity and every component that can be serialised to a binary file. */
+    void saveSnapshot(std::string_view path)
+    {
+        SnapshotWriter writer;
+        ecs::snapshot::fileHeader header;
+        writer.write(header);
+        mEntityManager.save(writer, header);
+        mComponentManager.save(writer, header);
+        writer.patch(0, header);
+        writer.saveToFile(path);
+    }
+
+    /**
+     * Replaces every entity and component with the ones in a snapshot made by saveSnapshot(). Components are
+     * matched by type so they must be registered, but not necessarily in the same order. Every loaded component
+     * counts as changed.
+     */
+    void loadSnapshot(std::string_view path)
+    {
+        SnapshotReader reader(path);
+        ecs::snapshot::fileHeader header;
+        reader.read(header);
+        if (header.magic != ecs::snapshot::magic || header.version != ecs::snapshot::version)
+        {
+            debug::log(std::string(path) + " is not a snapshot or was made by a different version.",
+                       debug::severity::Fatal);
+        }
+
+        const auto componentIds = mComponentManager.load(reader, header);
+        const auto entities = mEntityManager.load(reader, header, componentIds);
+
+        // Entities that share a signature are handed to the systems together.
+        std::unordered_map<unsigned long, std::vector<ecs::entity>> groups;
+        for (const ecs::entity entity : entities)
+        {
+            groups[mEntityManager.getSignature(entity).to_ulong()].push_back(entity);
+        }
+        mSystemManager.clearEntities();
+        for (const auto &[signature, group] : groups)
+        {
+            mSystemManager.entitySignatureChanged(group.data(), group.size(), ecs::signature(signature));
+        }
+    }
+
 protected:
+    template<typename Component>
+    void componentAdded(ecs::entity entity)
+    {
+        auto signature = mEntityManager.getSignature(entity);
+        signature.set(mComponentManager.getComponentId<Component>());
+        mEntityManager.setSignature(entity, signature);
+        mSystemManager.entitySignatureChanged(entity, signature);
+    }
+
+    ecs::signature getSignature(const Prefab &prefab)
+    {
+        ecs::signature signature;
+        for (const auto &component : prefab.mComponents) { signature.set(component->getComponentId()); }
+        return signature;
+    }
+
+    /**
+     * Creates the entities and their prefab components, skipping the component with skipId.
+     * @param notify Set to false if the caller still has components to add before systems are told.
+     */
+    std::vector<ecs::entity> createFromPrefab(size_t count, const Prefab &prefab, ecs::componentId skipId,
+                                              bool notify=true)
+    {
+        auto entities = mEntityManager.createEntities(count);
+        for (const auto &component : prefab.mComponents)
+        {
+            if (component->getComponentId() == skipId) { continue; }
+            component->instantiate(mComponentManager, entities.data(), entities.size());
+        }
+
+        if (notify)
+        {
+            const auto signature = getSignature(prefab);
+            mEntityManager.setSignature(entities.data(), entities.size(), signature);
+            mSystemManager.entitySignatureChanged(entities.data(), entities.size(), signature);
+        }
+        return entities;
+    }
+
     ComponentManager    mComponentManager;
     EntityManager       mEntityManager;
     SystemManager       mSystemManager;
+    Scheduler           mScheduler;
+    CommandManager      mCommandManager;
+    ThreadPool          mThreadPool;
 };
 
 
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "EcsCommon.h"
+
+#include <algorithm>
+#include <vector>
+#include <limits>
+
+/**
+ * An unordered set of entities that are stored contiguously so iterating over them is a linear scan.
+ * A sparse map from an entity's index to its slot is kept alongside so that lookups, inserts and removals are
+ * constant time.
+ * @author Ryan Purse
+ */
+class EntitySet
+{
+    typedef size_t index;
+public:
+    typedef std::vector<ecs::entity>::const_iterator const_iterator;
+    static constexpr index invalidIndex = std::numeric_limits<index>::max();
+
+    /** Adds an entity to the end of the set. Does nothing if it already exists. */
+    void insert(ecs::entity entity)
+    {
+        if (contains(entity)) { return; }
+        const ecs::entityIndex entityIndex = ecs::indexOf(entity);
+        if (entityIndex >= mSparse.size()) { mSparse.resize(entityIndex + 1, invalidIndex); }
+
+        mSparse[entityIndex] = mDense.size();
+        mDense.push_back(entity);
+        ++mVersion;
+    }
+
+    /** Removes an entity by swapping the last element into its slot. Does nothing if it doesn't exist. */
+    void erase(ecs::entity entity)
+    {
+        if (!contains(entity)) { return; }
+
+        const ecs::entityIndex entityIndex = ecs::indexOf(entity);
+        const index indexOfRemovedElement = mSparse[entityIndex];
+        const ecs::entity lastEntity = mDense.back();
+        mDense[indexOfRemovedElement] = lastEntity;
+        mSparse[ecs::indexOf(lastEntity)] = indexOfRemovedElement;
+
+        mDense.pop_back();
+        mSparse[entityIndex] = invalidIndex;
+        ++mVersion;
+    }
+
+    /** @return The slot that the entity is stored in or invalidIndex if it is not in the set. */
+    [[nodiscard]] index find(ecs::entity entity) const
+    {
+        const ecs::entityIndex entityIndex = ecs::indexOf(entity);
+        if (entityIndex >= mSparse.size()) { return invalidIndex; }
+
+        const index slot = mSparse[entityIndex];
+        // The generation must also match so that stale handles are not found.
+        return slot != invalidIndex && mDense[slot] == entity ? slot : invalidIndex;
+    }
+
+    [[nodiscard]] bool contains(ecs::entity entity) const { return find(entity) != invalidIndex; }
+
+    void reserve(size_t count) { mDense.reserve(count); }
+
+    /** Makes room for count more entities. Grows geometrically so repeated bulk inserts stay amortised. */
+    void reserveAdditional(size_t count)
+    {
+        const size_t required = mDense.size() + count;
+        if (required > mDense.capacity()) { mDense.reserve(std::max(required, mDense.capacity() * 2)); }
+    }
+
+    void clear()
+    {
+        mDense.clear();
+        mSparse.clear();
+        ++mVersion;
+    }
+
+    [[nodiscard]] size_t size() const { return mDense.size(); }
+    [[nodiscard]] bool empty() const { return mDense.empty(); }
+
+    /** @return A counter that goes up whenever an entity is inserted or erased. Used to tell if cached orders are stale. */
+    [[nodiscard]] uint64_t version() const { return mVersion; }
+    [[nodiscard]] const ecs::entity *data() const { return mDense.data(); }
+    [[nodiscard]] ecs::entity operator[](index i) const { return mDense[i]; }
+
+    [[nodiscard]] const_iterator begin() const { return std::begin(mDense); }
+    [[nodiscard]] const_iterator end() const { return std::end(mDense); }
+
+protected:
+    std::vector<ecs::entity> mDense;  // Iterated over by systems, so must be contiguous.
+    std::vector<index> mSparse;       // Entity index to slot in mDense.
+    uint64_t mVersion { 0 };
+};
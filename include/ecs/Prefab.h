@@ -0,0 +1,70 @@
+#pragma once
+
+#include "EcsCommon.h"
+#include "ComponentManager.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * A list of components that can be stamped onto many entities at once with EcsDirector::createEntities()
+ * or EcsDirector::instantiate().
+ * @author Ryan Purse
+ */
+class Prefab
+{
+    friend class EcsDirector;
+
+    /** An interface for the director since in doesn't know the component type explicitly. */
+    class IPrefabComponent
+    {
+    public:
+        virtual ~IPrefabComponent() = default;
+        [[nodiscard]] virtual ecs::componentId getComponentId() const = 0;
+        virtual void instantiate(ComponentManager &componentManager, const ecs::entity *entities,
+                                 size_t count) const = 0;
+    };
+
+    template<typename Component>
+    class PrefabComponent : public IPrefabComponent
+    {
+    public:
+        explicit PrefabComponent(Component component) : mComponent(std::move(component)) {}
+
+        [[nodiscard]] ecs::componentId getComponentId() const override
+        {
+            return ecs::typeIndex<ecs::componentFamily, Component>;
+        }
+
+        void instantiate(ComponentManager &componentManager, const ecs::entity *entities,
+                         size_t count) const override
+        {
+            componentManager.addComponents(entities, count, mComponent);
+        }
+
+        Component mComponent;
+    };
+
+public:
+    /** Adds a component to the prefab. Replaces the existing one if the prefab already has a Component. */
+    template<typename Component>
+    Prefab &add(Component component)
+    {
+        auto prefabComponent = std::make_unique<PrefabComponent<Component>>(std::move(component));
+        for (auto &existing : mComponents)
+        {
+            if (dynamic_cast<PrefabComponent<Component> *>(existing.get()))
+            {
+                existing = std::move(prefabComponent);
+                return *this;
+            }
+        }
+        mComponents.push_back(std::move(prefabComponent));
+        return *this;
+    }
+
+    [[nodiscard]] size_t size() const { return mComponents.size(); }
+
+protected:
+    std::vector<std::unique_ptr<IPrefabComponent>> mComponents;
+};
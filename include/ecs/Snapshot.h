@@ -0,0 +1,215 @@
+#pragma once
+
+#include "EcsCommon.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace ecs::snapshot
+{
+    const uint32_t magic = 0x53534345;  // "ECSS"
+    const uint32_t version = 1;
+
+    // Blocks are aligned so that a mapped file can be read in place.
+    const size_t alignment = 16;
+
+    /**
+     * The start of every snapshot. All offsets are in bytes from the start of the file.
+     * Layout: header, generations, signatures, free indices, then for each column its name, entities and
+     * components. The column table is last.
+     */
+    struct fileHeader
+    {
+        uint32_t magic          { snapshot::magic };
+        uint32_t version        { snapshot::version };
+        uint64_t entitySlots    { 0 };  // Length of the generation and signature arrays.
+        uint64_t freeCount      { 0 };
+        uint64_t aliveCount     { 0 };
+        uint64_t columnCount    { 0 };
+        uint64_t generationsOffset  { 0 };
+        uint64_t signaturesOffset   { 0 };
+        uint64_t freeIndicesOffset  { 0 };
+        uint64_t columnTableOffset  { 0 };
+    };
+
+    /** Where one component array lives in the file. */
+    struct columnRecord
+    {
+        uint64_t nameOffset     { 0 };
+        uint64_t nameLength     { 0 };
+        uint64_t count          { 0 };
+        uint64_t elementSize    { 0 };
+        uint64_t entitiesOffset { 0 };
+        uint64_t dataOffset     { 0 };
+        uint64_t dataSize       { 0 };
+        uint32_t isRaw          { 0 };  // Raw columns are a straight copy of the component array.
+        uint32_t componentId    { 0 };  // The signature bit that the component had when it was saved.
+    };
+}
+
+/**
+ * Builds a snapshot in memory. Trivially copyable values are written as raw bytes. Anything else needs an
+ * overload or a serializer registered with the director.
+ * @author Ryan Purse
+ */
+class SnapshotWriter
+{
+public:
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    void write(const T &value)
+    {
+        writeBytes(&value, sizeof(T));
+    }
+
+    void write(const std::string &value)
+    {
+        write(static_cast<uint64_t>(value.size()));
+        writeBytes(value.data(), value.size());
+    }
+
+    /** Writes the size and then each element. Trivially copyable elements are written in one go. */
+    template<typename T>
+    void write(const std::vector<T> &values)
+    {
+        write(static_cast<uint64_t>(values.size()));
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            writeBytes(values.data(), values.size() * sizeof(T));
+        }
+        else
+        {
+            for (const T &value : values) { write(value); }
+        }
+    }
+
+    /** Writes an aligned block of count values. @return The offset that the block starts at. */
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    size_t writeArray(const T *values, size_t count)
+    {
+        align();
+        const size_t start = offset();
+        writeBytes(values, count * sizeof(T));
+        return start;
+    }
+
+    /** Overwrites a value that has already been written, such as a header. */
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    void patch(size_t at, const T &value)
+    {
+        std::memcpy(mBuffer.data() + at, &value, sizeof(T));
+    }
+
+    void align()
+    {
+        mBuffer.resize((mBuffer.size() + ecs::snapshot::alignment - 1) / ecs::snapshot::alignment
+                * ecs::snapshot::alignment);
+    }
+
+    [[nodiscard]] size_t offset() const { return mBuffer.size(); }
+
+    void saveToFile(std::string_view path) const;
+
+protected:
+    void writeBytes(const void *data, size_t size)
+    {
+        const size_t start = mBuffer.size();
+        mBuffer.resize(start + size);
+        if (size > 0) { std::memcpy(mBuffer.data() + start, data, size); }
+    }
+
+    std::vector<std::byte> mBuffer;
+};
+
+/**
+ * Reads back a snapshot made by SnapshotWriter. The whole file is read in one go and every read is bounds
+ * checked, so a truncated file is reported instead of read past.
+ * @author Ryan Purse
+ */
+class SnapshotReader
+{
+public:
+    /** Reads the whole file into memory. */
+    explicit SnapshotReader(std::string_view path);
+
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    void read(T &value)
+    {
+        readBytes(&value, sizeof(T));
+    }
+
+    /**
+     * Reads the size written before a list of elements.
+     * @param minElementSize The least amount of bytes each element can take. Stops a corrupt size from being
+     * used to allocate too much.
+     */
+    size_t readSize(size_t minElementSize=1)
+    {
+        uint64_t size { 0 };
+        read(size);
+        validateRange(mPosition, size, minElementSize);
+        return static_cast<size_t>(size);
+    }
+
+    void read(std::string &value)
+    {
+        const size_t size = readSize();
+        value.assign(reinterpret_cast<const char *>(mBuffer.data() + mPosition), size);
+        mPosition += size;
+    }
+
+    template<typename T>
+    void read(std::vector<T> &values)
+    {
+        const size_t size = readSize(std::is_trivially_copyable_v<T> ? sizeof(T) : 1);
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            values.resize(size);
+            readBytes(values.data(), size * sizeof(T));
+        }
+        else
+        {
+            values.resize(size);
+            for (T &value : values) { read(value); }
+        }
+    }
+
+    /** Copies count values from an aligned block written by SnapshotWriter::writeArray(). */
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    void readArray(size_t at, T *values, size_t count)
+    {
+        validateRange(at, count, sizeof(T));
+        if (count > 0) { std::memcpy(values, mBuffer.data() + at, count * sizeof(T)); }
+    }
+
+    void seek(size_t at)
+    {
+        validateRange(at, 0, 1);
+        mPosition = at;
+    }
+
+    [[nodiscard]] size_t offset() const { return mPosition; }
+
+protected:
+    void readBytes(void *data, size_t size)
+    {
+        validateRange(mPosition, size, 1);
+        if (size > 0) { std::memcpy(data, mBuffer.data() + mPosition, size); }
+        mPosition += size;
+    }
+
+    /** Logs a fatal error if count elements of elementSize bytes starting at at would go past the end of the file. */
+    void validateRange(size_t at, uint64_t count, size_t elementSize) const;
+
+    std::vector<std::byte> mBuffer;
+    size_t mPosition { 0 };
+};
@@ -2,9 +2,9 @@
 
 #include "EcsCommon.h"
 #include "ComponentManager.h"
-#include "Components.h"
-
-#include <set>
+#include "View.h"
+#include "EntitySet.h"
+#include "CommandManager.h"
 
 /**
  * A system base class that handles common functionality.
@@ -13,17 +13,83 @@
 class System
 {
 public:
+    virtual ~System() = default;
+
+    /** Called once per frame by the scheduler if the system has been scheduled. */
+    virtual void update(float /*deltaTime*/) {}
 
-    std::set<ecs::entity> mEntities;
+    /**
+     * Moves the system on to a new tick so that changes are tracked from the previous run. The scheduler calls
+     * this before update(). Systems that are run by hand should call it at the start of each run.
+     */
+    void beginRun()
+    {
+        mLastRunTick = mThisRunTick;
+        mThisRunTick = mComponentManager->advanceTick();
+    }
+
+    EntitySet mEntities;
 protected:
+    /** A const Component gives read only access. Otherwise the component is marked as changed by this system. */
     template<typename Component>
     Component &getComponent(ecs::entity entity)
     {
-        return mComponentManager->getComponent<Component>(entity);
+        return mComponentManager->getComponent<Component>(entity, mThisRunTick);
+    }
+
+    /** @return True if the entity's Component has been written to since this system last ran. */
+    template<typename Component>
+    [[nodiscard]] bool hasChanged(ecs::entity entity) const
+    {
+        return mComponentManager->getComponentArray<Component>()->getChangeTick(entity) > mLastRunTick;
+    }
+
+    /** @return True if any Component has been written to, added or removed since this system last ran. */
+    template<typename Component>
+    [[nodiscard]] bool hasAnyChanged() const
+    {
+        return mComponentManager->getComponentArray<Component>()->getLastChangeTick() > mLastRunTick;
     }
+
+    template<typename Component>
+    [[nodiscard]] bool hasComponent(ecs::entity entity) const
+    {
+        return mComponentManager->hasComponent<Component>(entity);
+    }
+
+    /**
+     * Creates a view over every entity in this system. Before the system's first run, writes through the view are
+     * stamped with a new tick, the same as getComponent().
+     * @example for (auto [transform, uniforms] : view<const Transform, RendererUniforms>()) { ... }
+     */
+    template<typename... Components>
+    View<Components...> view()
+    {
+        return View<Components...>(
+                mEntities, mThreadPool, mThisRunTick == 0 ? mComponentManager->advanceTick() : mThisRunTick,
+                mLastRunTick,
+                mComponentManager->getComponentArray<std::remove_const_t<Components>>()...);
+    }
+
+    /**
+     * @return The calling thread's command buffer. Use it to make structural changes while iterating or from
+     * worker threads. The changes are applied once every scheduled system has finished.
+     */
+    CommandBuffer &getCommandBuffer()
+    {
+        return mCommandManager->getCommandBuffer();
+    }
+
+    /** @return The director's thread pool, or nullptr if the system hasn't been registered. */
+    [[nodiscard]] ThreadPool *getThreadPool() const { return mThreadPool; }
 private:
     friend class EcsDirector;
     ComponentManager *mComponentManager;
+    ThreadPool *mThreadPool { nullptr };
+    CommandManager *mCommandManager { nullptr };
+
+    ecs::tick mThisRunTick { 0 };
+    ecs::tick mLastRunTick { 0 };
 };
 
 
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A work-stealing thread pool. Each worker owns a queue that it pops from the back of and steals from the
+ * front of the other workers' queues when it runs dry. Threads that are waiting on work can help out by
+ * running pending tasks themselves.
+ * @author Ryan Purse
+ */
+class ThreadPool
+{
+public:
+    typedef std::function<void()> task;
+
+    explicit ThreadPool(size_t threadCount=defaultThreadCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /** Queues a task. Tasks submitted from a worker go onto that worker's own queue. */
+    void submit(task job);
+
+    /**
+     * Runs a single pending task on the calling thread.
+     * @return False if there was nothing to run.
+     */
+    bool tryRunPendingTask();
+
+    /** Runs pending tasks on the calling thread until isDone() returns true. */
+    template<typename Predicate>
+    void waitUntil(Predicate isDone)
+    {
+        while (!isDone())
+        {
+            if (!tryRunPendingTask()) { std::this_thread::yield(); }
+        }
+    }
+
+    /**
+     * Calls func(taskIndex) for every index in [0, taskCount) across the pool and waits for all of them to finish.
+     * The calling thread runs the first task itself. Any exception thrown by a task is rethrown here.
+     */
+    template<typename Func>
+    void parallelFor(size_t taskCount, Func &&func)
+    {
+        if (taskCount == 0) { return; }
+
+        std::atomic<size_t> remaining { taskCount - 1 };
+        std::exception_ptr exception;
+        std::mutex exceptionMutex;
+        auto runTask = [&](size_t taskIndex) {
+            try { func(taskIndex); }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!exception) { exception = std::current_exception(); }
+            }
+        };
+
+        for (size_t i = 1; i < taskCount; ++i)
+        {
+            submit([&runTask, &remaining, i]() {
+                runTask(i);
+                remaining.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+        runTask(0);
+        waitUntil([&remaining]() { return remaining.load(std::memory_order_acquire) == 0; });
+
+        if (exception) { std::rethrow_exception(exception); }
+    }
+
+    /** @return The number of worker threads. Can be zero, in which case waiting threads run everything. */
+    [[nodiscard]] size_t size() const { return mThreads.size(); }
+
+    /** @return One less than the hardware concurrency so that the main thread has a core to itself. */
+    static size_t defaultThreadCount();
+
+protected:
+    struct taskQueue
+    {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool popTask(size_t queueIndex, task &job);
+    bool stealTask(size_t thiefIndex, task &job);
+    [[nodiscard]] size_t currentQueue() const;
+
+    std::vector<std::unique_ptr<taskQueue>> mQueues;
+    std::vector<std::thread> mThreads;
+
+    std::atomic<size_t> mPendingCount{ 0 };
+    std::atomic<size_t> mNextQueue{ 0 };
+
+    std::mutex mSleepMutex;
+    std::condition_variable mSleepCondition;
+    bool mIsRunning{ true };
+};
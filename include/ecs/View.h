@@ -0,0 +1,206 @@
+#pragma once
+
+#include "EcsCommon.h"
+#include "ComponentArray.h"
+#include "EntitySet.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A typed query over a list of entities. Each component array is resolved once when the view is made so that
+ * iterating only costs a single lookup per component. Const qualified components are handed out as const references.
+ * Non-const components count as changed at the view's tick when they are handed out.
+ * @author Ryan Purse
+ */
+template<typename... Components>
+class View
+{
+    typedef EntitySet entityList;
+    typedef std::tuple<ComponentArray<std::remove_const_t<Components>> *...> arrayList;
+    typedef uint32_t componentMask;  // Bit i refers to the i-th type in Components.
+
+    static_assert(sizeof...(Components) <= sizeof(componentMask) * 8, "Too many components in a single view.");
+public:
+    class Iterator
+    {
+    public:
+        Iterator(size_t i, const View &view)
+            : mIndex(i), mView(view) { skipUnchanged(); }
+
+        std::tuple<Components &...> operator*() const
+        {
+            return { mView.template fetch<Components>(entity())... };
+        }
+
+        [[nodiscard]] ecs::entity entity() const { return mView.mEntities[mIndex]; }
+
+        Iterator &operator++()
+        {
+            ++mIndex;
+            skipUnchanged();
+            return *this;
+        }
+
+        bool operator!=(const Iterator &other) const { return mIndex != other.mIndex; }
+
+    protected:
+        void skipUnchanged()
+        {
+            while (mIndex < mView.mEntities.size() && !mView.isIncluded(mView.mEntities[mIndex])) { ++mIndex; }
+        }
+
+        size_t mIndex;
+        const View &mView;
+    };
+
+    /**
+     * @param thisRunTick The tick that writes through this view are stamped with.
+     * @param lastRunTick Components written to after this tick count as changed.
+     */
+    explicit View(const entityList &entities, ThreadPool *threadPool, ecs::tick thisRunTick, ecs::tick lastRunTick,
+                  ComponentArray<std::remove_const_t<Components>> *...arrays)
+        : mEntities(entities), mThreadPool(threadPool), mThisRunTick(thisRunTick), mLastRunTick(lastRunTick),
+          mArrays(arrays...) {}
+
+    Iterator begin() const { return Iterator(isEmpty() ? mEntities.size() : 0, *this); }
+    Iterator end() const { return Iterator(mEntities.size(), *this); }
+
+    /**
+     * @return A copy of this view that only visits entities where at least one of the Changed components has
+     * been written to since the system last ran. If none of them have changed anywhere, iterating costs nothing.
+     * @example view<RendererUniforms, const Transform>().changed<Transform>()
+     */
+    template<typename... Changed>
+    [[nodiscard]] View changed() const
+    {
+        static_assert(((positionOf<Changed>() != sizeof...(Components)) && ...),
+                      "Changed components must also be part of the view.");
+        View filtered = *this;
+        filtered.mChangedMask |= ((componentMask(1) << positionOf<Changed>()) | ...);
+        return filtered;
+    }
+
+    /**
+     * Calls func(entity, components...) for every entity in the view.
+     */
+    template<typename Func>
+    void each(Func &&func) const
+    {
+        if (isEmpty()) { return; }
+        eachInRange(0, mEntities.size(), func);
+    }
+
+    /**
+     * Calls func(entity, components...) for every entity in the view, split into chunks that are run across the
+     * thread pool. Chunk boundaries fall on cache lines of the entity list so that workers never share a line.
+     * Views smaller than serialThreshold are run on the calling thread instead.
+     * @warning func is called from several threads at once. Only write to the components that are handed to it.
+     */
+    template<typename Func>
+    void parallelForEach(Func &&func, size_t serialThreshold=1024, size_t minChunkSize=256) const
+    {
+        if (isEmpty()) { return; }
+
+        const size_t count = mEntities.size();
+        if (!mThreadPool || mThreadPool->size() == 0 || count < serialThreshold)
+        {
+            eachInRange(0, count, func);
+            return;
+        }
+
+        // A few chunks per thread lets the pool balance out any uneven work.
+        const size_t threadCount = mThreadPool->size() + 1;
+        const size_t chunkCount = std::max<size_t>(1, std::min(count / minChunkSize, threadCount * 4));
+
+        constexpr size_t entitiesPerLine = ecs::cacheLineSize / sizeof(ecs::entity);
+        const size_t chunkSize = ((count + chunkCount - 1) / chunkCount + entitiesPerLine - 1)
+                / entitiesPerLine * entitiesPerLine;
+
+        // How far the start of the list is into a cache line so that the boundaries can be shifted to match.
+        const size_t offset = (reinterpret_cast<uintptr_t>(mEntities.data()) % ecs::cacheLineSize)
+                / sizeof(ecs::entity);
+
+        const size_t alignedChunkCount = (count + offset + chunkSize - 1) / chunkSize;
+        mThreadPool->parallelFor(alignedChunkCount, [&](size_t chunk) {
+            const size_t begin = chunk == 0 ? 0 : chunk * chunkSize - offset;
+            const size_t end = std::min(count, (chunk + 1) * chunkSize - offset);
+            eachInRange(begin, end, func);
+        });
+    }
+
+    /** @return The number of entities in the view, ignoring any changed filter. */
+    [[nodiscard]] size_t size() const { return mEntities.size(); }
+
+protected:
+    template<typename Func>
+    void eachInRange(size_t begin, size_t end, Func &func) const
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const ecs::entity entity = mEntities[i];
+            if (!isIncluded(entity)) { continue; }
+            func(entity, fetch<Components>(entity)...);
+        }
+    }
+
+    template<typename Component>
+    Component &fetch(ecs::entity entity) const
+    {
+        auto *componentArray = std::get<ComponentArray<std::remove_const_t<Component>> *>(mArrays);
+        if constexpr (std::is_const_v<Component>)
+        {
+            return componentArray->getData(entity);
+        }
+        else
+        {
+            return componentArray->getData(entity, mThisRunTick);
+        }
+    }
+
+    /** @return The position of Component within Components or sizeof...(Components) if it is not there. */
+    template<typename Component>
+    static constexpr size_t positionOf()
+    {
+        constexpr bool matches[] = { std::is_same_v<std::remove_const_t<Component>, std::remove_const_t<Components>>... };
+        for (size_t i = 0; i < sizeof...(Components); ++i)
+        {
+            if (matches[i]) { return i; }
+        }
+        return sizeof...(Components);
+    }
+
+    /** @return True if none of the filtered arrays have been written to at all, so there is nothing to visit. */
+    [[nodiscard]] bool isEmpty() const
+    {
+        if (mChangedMask == 0) { return false; }
+        return !anyInMask(std::index_sequence_for<Components...>{}, [this](auto *componentArray) {
+            return componentArray->getLastChangeTick() > mLastRunTick;
+        });
+    }
+
+    [[nodiscard]] bool isIncluded(ecs::entity entity) const
+    {
+        if (mChangedMask == 0) { return true; }
+        return anyInMask(std::index_sequence_for<Components...>{}, [this, entity](auto *componentArray) {
+            return componentArray->getChangeTick(entity) > mLastRunTick;
+        });
+    }
+
+    template<size_t... I, typename Predicate>
+    bool anyInMask(std::index_sequence<I...>, Predicate predicate) const
+    {
+        return (((mChangedMask & (componentMask(1) << I)) != 0 && predicate(std::get<I>(mArrays))) || ...);
+    }
+
+    const entityList &mEntities;
+    ThreadPool *mThreadPool;
+    ecs::tick mThisRunTick;
+    ecs::tick mLastRunTick;
+    componentMask mChangedMask { 0 };
+    arrayList mArrays;
+};
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <glm.hpp>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Runs the render passes of a frame. Each pass declares the textures and buffers that it reads and writes, which
+ * decides the order that passes run in. Passes whose results are never used are culled. Textures created by the
+ * graph are transient: they are taken from a pool just before their first use and given back after their last, so
+ * textures whose lifetimes don't overlap share the same memory. Every pass that runs is timed on the GPU.
+ * The graph is built once and compiled the first time that it runs after a pass is added or the backbuffer is
+ * resized.
+ * @example frameGraph.addPass("Forward", [&](FrameGraph::builder &builder) { builder.write(colour); }, execute);
+ * @author Ryan Purse
+ */
+class FrameGraph
+{
+public:
+    /** Refers to a texture or buffer in the graph. */
+    struct resource
+    {
+        static constexpr unsigned int invalidId { std::numeric_limits<unsigned int>::max() };
+        unsigned int id { invalidId };
+
+        [[nodiscard]] bool isValid() const { return id != invalidId; }
+        bool operator==(const resource &other) const { return id == other.id; }
+    };
+
+    /** A transient texture. Its size is the backbuffer's multiplied by scale. */
+    struct textureDesc
+    {
+        unsigned int format { 0 };  // A sized internal format, such as GL_RGBA8 or GL_DEPTH_COMPONENT24.
+        float scale         { 1.f };
+
+        bool operator==(const textureDesc &other) const = default;
+    };
+
+    /** Given to a pass's setup function so that it can declare what it uses. */
+    class builder
+    {
+    public:
+        resource read(resource target);
+
+        /** Written textures are attached to the pass's framebuffer in the order that they are written. */
+        resource write(resource target);
+
+        /** Stops the pass from being culled even if nothing reads what it writes. */
+        void setSideEffects();
+
+    private:
+        friend class FrameGraph;
+        builder(FrameGraph &graph, size_t pass) : mGraph(graph), mPass(pass) {}
+
+        FrameGraph &mGraph;
+        size_t mPass;
+    };
+
+    /** Given to a pass while it runs. The pass's framebuffer is already bound and its viewport set. */
+    class context
+    {
+    public:
+        [[nodiscard]] unsigned int getTexture(resource target) const;
+        [[nodiscard]] unsigned int getBuffer(resource target) const;
+
+        /** @return The framebuffer with the pass's written textures attached. 0 if it writes to the backbuffer. */
+        [[nodiscard]] unsigned int getFramebuffer() const;
+
+        [[nodiscard]] glm::ivec2 getSize() const;
+
+    private:
+        friend class FrameGraph;
+        context(const FrameGraph &graph, size_t pass) : mGraph(graph), mPass(pass) {}
+
+        const FrameGraph &mGraph;
+        size_t mPass;
+    };
+
+    struct passTiming
+    {
+        std::string_view name;
+        double milliseconds;  // Read back a few frames late so that the CPU never waits for the GPU.
+        bool culled;
+    };
+
+    FrameGraph();
+    ~FrameGraph();
+
+    FrameGraph(const FrameGraph &) = delete;
+    FrameGraph &operator=(const FrameGraph &) = delete;
+
+    /** @return The default framebuffer, or whichever one was given to setBackbuffer(). */
+    [[nodiscard]] resource getBackbuffer() const { return mBackbuffer; }
+
+    /** Draws the frame into a framebuffer other than the window's, such as an offscreen one. */
+    void setBackbuffer(unsigned int framebuffer, const glm::ivec2 &size);
+
+    /** Transient textures are resized with the backbuffer, which recompiles the graph. */
+    void setBackbufferSize(const glm::ivec2 &size);
+
+    resource createTexture(std::string name, const textureDesc &desc);
+
+    /** A buffer that is owned outside of the graph. Only used to order the passes that read and write it. */
+    resource importBuffer(std::string name, unsigned int id);
+
+    /**
+     * @param setup Called once straight away to declare what the pass reads and writes.
+     * @param execute Called every frame that the pass isn't culled.
+     */
+    void addPass(std::string name, const std::function<void(builder &)> &setup,
+                 std::function<void(const context &)> execute);
+
+    /** Runs every pass that isn't culled in order. */
+    void execute();
+
+    /** @return Every pass in the order that they run, followed by the culled ones. */
+    [[nodiscard]] std::vector<passTiming> getTimings() const;
+
+    /** @return The number of textures that the transient textures were packed into. */
+    [[nodiscard]] size_t getPooledTextureCount() const { return mPool.size(); }
+
+    [[nodiscard]] size_t getTransientTextureCount() const;
+
+protected:
+    /** How many frames of timer queries are in flight before the oldest is read. */
+    static constexpr size_t queryLatency { 3 };
+
+    struct resourceNode
+    {
+        std::string name;
+        textureDesc desc;
+        unsigned int id { 0 };          // The GL name of imported resources, or of the pooled texture once compiled.
+        bool isTexture  { false };
+        bool isImported { false };
+        size_t poolIndex { 0 };
+    };
+
+    struct passNode
+    {
+        std::string name;
+        std::function<void(const context &)> execute;
+        std::vector<unsigned int> reads;
+        std::vector<unsigned int> writes;
+        bool hasSideEffects { false };
+
+        // Found by compile().
+        bool isCulled { true };
+        unsigned int framebuffer { 0 };
+        glm::ivec2 size { 0 };
+        bool bindsFramebuffer { false };  // False for passes that don't write to any texture.
+        bool ownsFramebuffer { false };   // Only framebuffers created by the graph are deleted, not the backbuffer.
+        std::array<unsigned int, queryLatency> queries { };
+        std::array<bool, queryLatency> isQueryPending { };
+        double milliseconds { 0.0 };
+    };
+
+    /** A real texture that transient textures are placed in. */
+    struct pooledTexture
+    {
+        textureDesc desc;
+        glm::ivec2 size { 0 };
+        unsigned int id { 0 };
+    };
+
+    /** Culls, orders, places transient textures and creates each pass's framebuffer. */
+    void compile();
+
+    /**
+     * Deletes each pass's queries and the framebuffers that the graph created. Pooled textures are left for compile()
+     * to reuse or delete.
+     */
+    void release();
+
+    /** @return The indices of every pass that pass must run after. */
+    [[nodiscard]] std::vector<size_t> findDependencies(size_t pass) const;
+
+    [[nodiscard]] glm::ivec2 getTextureSize(const textureDesc &desc) const;
+    [[nodiscard]] static bool isDepthFormat(unsigned int format);
+
+    /** @return A description of the compiled graph for the log. */
+    [[nodiscard]] std::string describe() const;
+
+    std::vector<resourceNode> mResources;
+    std::vector<passNode> mPasses;
+    std::vector<size_t> mOrder;  // Indices of the passes that aren't culled, in the order that they run.
+    std::vector<pooledTexture> mPool;
+    resource mBackbuffer;
+    glm::ivec2 mBackbufferSize { 1 };
+    size_t mFrame { 0 };
+    bool mIsDirty { true };
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <map>
+
+/**
+ * Hands out ranges of a fixed size pool, such as a GPU buffer. The allocator only does the book keeping, so the
+ * units can be bytes, vertices or anything else. Freed ranges are merged with their neighbours and each
+ * allocation takes the smallest free range that fits to keep large ranges intact.
+ * @author Ryan Purse
+ */
+class FreeListAllocator
+{
+public:
+    static constexpr size_t invalidOffset = std::numeric_limits<size_t>::max();
+
+    explicit FreeListAllocator(size_t capacity=0);
+
+    /** @return The start of a range of size units, or invalidOffset if no free range is large enough. */
+    size_t allocate(size_t size);
+
+    /** Returns a range given out by allocate(). */
+    void free(size_t offset, size_t size);
+
+    /** Adds space to the end of the pool. */
+    void grow(size_t newCapacity);
+
+    /** Forgets every allocation and sets the pool's size. Used once the pool has been compacted elsewhere. */
+    void reset(size_t capacity, size_t used=0);
+
+    [[nodiscard]] size_t capacity() const { return mCapacity; }
+    [[nodiscard]] size_t used() const { return mUsed; }
+    [[nodiscard]] size_t largestFreeRange() const;
+
+    /** @return 0 when all free space is in one range, approaching 1 as it gets split into smaller pieces. */
+    [[nodiscard]] float fragmentation() const;
+
+protected:
+    void addFreeRange(size_t offset, size_t size);
+    void removeFreeRange(std::map<size_t, size_t>::iterator it);
+
+    std::map<size_t, size_t> mFreeByOffset;         // Offset to size. Sorted so that neighbours can be merged.
+    std::multimap<size_t, size_t> mFreeBySize;      // Size to offset. Sorted so that the best fit is a lookup.
+    size_t mCapacity { 0 };
+    size_t mUsed { 0 };
+};
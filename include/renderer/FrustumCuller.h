@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glm.hpp>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Tests bounding spheres against the camera's frustum. Spheres are stored as separate x, y, z and radius arrays
+ * so that each plane test covers a batch of spheres at once: eight with AVX, four with SSE, otherwise one.
+ * @example culler.setFrustum(vpMatrix); culler.add(centre, radius); ... for (auto i : culler.cull()) { ... }
+ * @author Ryan Purse
+ */
+class FrustumCuller
+{
+public:
+    /** The number of spheres tested by one instruction batch. */
+    static const size_t batchSize;
+
+    /**
+     * @return The left, right, bottom, top, near and far planes of a view projection matrix as (normal, d),
+     * normalised so that dot(normal, point) + d is a distance. Normals point into the frustum.
+     */
+    static std::array<glm::vec4, 6> extractPlanes(const glm::mat4 &vpMatrix);
+
+    void setFrustum(const glm::mat4 &vpMatrix);
+
+    /** Removes every sphere. Memory is kept for the next frame. */
+    void clear();
+
+    /** Adds a world space sphere. Its index is the number of spheres added before it. */
+    void add(const glm::vec3 &centre, float radius);
+
+    /** @return The indices of the spheres that touch the frustum, in the order that they were added. */
+    const std::vector<unsigned int> &cull();
+
+    [[nodiscard]] size_t getTestedCount() const { return mTestedCount; }
+    [[nodiscard]] size_t getCulledCount() const { return mCulledCount; }
+
+protected:
+    std::array<glm::vec4, 6> mPlanes { };
+
+    // Padded up to a whole batch by cull().
+    std::vector<float> mX;
+    std::vector<float> mY;
+    std::vector<float> mZ;
+    std::vector<float> mRadius;
+
+    std::vector<unsigned int> mVisible;
+    size_t mCount       { 0 };
+    size_t mTestedCount { 0 };
+    size_t mCulledCount { 0 };
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Components.h"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ * Every material in one shader storage buffer, indexed by material id. Materials are kept on the CPU as well so
+ * that changing one only marks its range as dirty. The next upload() sends the dirty range and nothing else.
+ * @author Ryan Purse
+ */
+class MaterialPool
+{
+public:
+    /** A material laid out the way Basic.shader's MaterialBuffer expects it (std430). */
+    struct gpuMaterial
+    {
+        glm::vec4 kAmbient  { 0.f };
+        glm::vec4 kDiffuse  { 1.f };
+        glm::vec4 kSpecular { 1.f };
+        float nSpecular     { 0.f };
+        float dissolve      { 1.f };
+        float padding[2]    { };
+    };
+
+    MaterialPool();
+    ~MaterialPool();
+
+    MaterialPool(const MaterialPool &) = delete;
+    MaterialPool &operator=(const MaterialPool &) = delete;
+
+    /** @return The id of the material. */
+    unsigned int add(const Material &material);
+
+    /**
+     * Adds the materials next to each other so that they can be indexed from the first one.
+     * @return The id of the first material.
+     */
+    unsigned int add(std::span<const Material> materials);
+
+    /** Replaces a material. It is sent to the GPU on the next upload(). */
+    void set(unsigned int id, const Material &material);
+
+    /** Sends the materials that have changed since the last upload. Grows the buffer if there are new ones. */
+    void upload();
+
+    void bindBase(unsigned int index) const;
+
+    [[nodiscard]] unsigned int getId() const { return mId; }
+
+    /** @return True if the material is see through, so must be blended. */
+    [[nodiscard]] bool isTransparent(unsigned int id) const { return mMaterials[id].dissolve < 1.f; }
+
+    [[nodiscard]] size_t size() const { return mMaterials.size(); }
+
+    /** @return The number of bytes sent by the last upload(). Zero if no material changed. */
+    [[nodiscard]] size_t getLastUploadBytes() const { return mLastUploadBytes; }
+
+protected:
+    static gpuMaterial toGpu(const Material &material);
+    void markDirty(size_t first, size_t last);
+
+    std::vector<gpuMaterial> mMaterials;
+    unsigned int mId            { 0 };
+    size_t mCapacity            { 0 };
+    size_t mDirtyFirst          { 0 };
+    size_t mDirtyLast           { 0 };
+    size_t mLastUploadBytes     { 0 };
+};
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "System.h"
+#include "Components.h"
 #include "Shader.h"
 #include "TextureSystem.h"
+#include "MaterialPool.h"
 
 /**
  * Handles assignment of uniforms from entities before being rendered to the screen.
@@ -17,14 +19,28 @@ public:
 
     void bind() const;
     static void unbind();
-    void setupMaterials(const std::vector<unsigned int> &materialIds, unsigned int diffuseTextureIds,
-                        unsigned int normalMapIds);
+    /** Binds an entity's texture arrays, or the default ones if the entity has none. */
+    void bindTextures(unsigned int diffuseTextureIds, unsigned int normalMapIds) const;
+
+    /** Copies the Material components that were written to since the last call into the pool. Doesn't touch the GPU. */
+    void updateMaterials();
+
+    /** Sends any materials that were added or changed to the GPU and binds them for Basic.shader. */
+    void uploadMaterials();
+
+    /** @return The id of the first of an entity's materials, or the default material if it has none. */
+    [[nodiscard]] unsigned int getMaterialOffset(const std::vector<unsigned int> &materialIds) const;
+
+    /** @return True if any of an entity's materials are see through. */
+    [[nodiscard]] bool isTransparent(const std::vector<unsigned int> &materialIds) const;
+
     unsigned int addMaterial(const Material &material);
 
+    [[nodiscard]] const MaterialPool &getMaterialPool() const { return mMaterialPool; }
+
     Shader mShader { "../res/shaders/Basic.shader" };
 protected:
-    unsigned int mNextId { 0 };
-    std::unordered_map<unsigned int, Material> mMaterials;
+    MaterialPool mMaterialPool;
     TextureSystem mTextureSystem;
     unsigned int mRendererId { 0 };
     unsigned int mDefaultId{ 0 };
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Components.h"
+#include "FreeListAllocator.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Keeps every mesh on the GPU in one vertex buffer and one index buffer so that meshes are uploaded once and
+ * drawn without rebinding anything. Each mesh gets its own range of both buffers, which is drawn with
+ * glDrawElementsBaseVertex(). The buffers are immutable, so running out of space or packing the ranges back
+ * together moves everything into new buffers with a GPU side copy.
+ * @author Ryan Purse
+ */
+class MeshArena
+{
+public:
+    /** Where a mesh lives in the arena's buffers. Indices are relative to baseVertex. */
+    struct drawRange
+    {
+        int baseVertex          { 0 };
+        unsigned int firstIndex { 0 };
+        unsigned int indexCount { 0 };
+        unsigned int vertexCount{ 0 };
+
+        [[nodiscard]] bool isValid() const { return indexCount > 0; }
+    };
+
+    MeshArena(size_t vertexCapacity=65'536, size_t indexCapacity=262'144);
+    ~MeshArena();
+
+    MeshArena(const MeshArena &) = delete;
+    MeshArena &operator=(const MeshArena &) = delete;
+
+    /**
+     * Uploads the mesh so that it can be drawn with handle. Grows the buffers if there is no room. Meshes without
+     * any vertices or indices are skipped.
+     */
+    void add(MeshHandle handle, const PolygonalMesh &mesh);
+
+    /** Frees the mesh's ranges to be reused. */
+    void remove(MeshHandle handle);
+
+    [[nodiscard]] const drawRange &get(MeshHandle handle) const;
+
+    /** Packs every mesh to the start of the buffers so that the free space is in one piece again. */
+    void defragment();
+
+    /** Binds the vertex array that reads from the arena. One bind covers every mesh. */
+    void bind() const;
+
+    /** @return The number of bytes uploaded since the last call. Zero on frames where no mesh was added. */
+    size_t takeUploadedBytes();
+
+    /** @return The worst fragmentation of the two buffers. @see FreeListAllocator::fragmentation() */
+    [[nodiscard]] float fragmentation() const;
+
+protected:
+    /** Moves every mesh into new buffers of the given capacities, packed together in handle order. */
+    void reallocate(size_t vertexCapacity, size_t indexCapacity);
+
+    FreeListAllocator mVertexAllocator;
+    FreeListAllocator mIndexAllocator;
+    std::vector<drawRange> mRanges;  // Indexed by MeshHandle::id.
+
+    unsigned int mVertexArrayId     { 0 };
+    unsigned int mVertexBufferId    { 0 };
+    unsigned int mIndexBufferId     { 0 };
+    size_t mUploadedBytes           { 0 };
+};
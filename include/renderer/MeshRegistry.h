@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Components.h"
+#include "MeshArena.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A model whose geometry is owned by a MeshRegistry. Materials are small, so each entity gets its own copy.
+ */
+struct RegisteredModel
+{
+    MeshHandle mesh;
+    std::vector<Material> materials;
+    std::vector<MaterialTexture> matTextures;
+};
+
+/**
+ * Owns every mesh so that entities only need to hold a MeshHandle. Loading the same path twice, or adding
+ * geometry identical to a mesh that already exists, gives back the existing handle. Meshes are uploaded to the
+ * arena as they are added and are never uploaded again.
+ * @author Ryan Purse
+ */
+class MeshRegistry
+{
+public:
+    /**
+     * Takes ownership of a mesh. Identical geometry that has already been added is reused instead. The handle is
+     * invalid if the mesh has no vertices or indices.
+     * @param source Where the mesh came from, such as a model's path. Snapshots store this instead of the handle,
+     * which is only valid in this run.
+     */
+    MeshHandle add(PolygonalMesh &&mesh, std::string_view source={});
+
+    /**
+     * Loads a model the first time its path is seen. The handle is invalid if the model failed to load.
+     * @see loadModel()
+     */
+    const RegisteredModel &load(std::string_view path);
+
+    /** Frees the mesh on the GPU and in memory. Its handle is not reused. */
+    void remove(MeshHandle handle);
+
+    /** @return The CPU copy of the mesh, which is empty if CPU copies are not being kept. */
+    [[nodiscard]] const PolygonalMesh &get(MeshHandle handle) const;
+
+    /** @return The mesh's bounds. These are kept even if the CPU copy isn't. */
+    [[nodiscard]] const Bounds &getBounds(MeshHandle handle) const;
+
+    /** @return The source that the mesh was added with. Empty if it wasn't given one. */
+    [[nodiscard]] const std::string &getSource(MeshHandle handle) const;
+
+    /** @return The mesh that was added with source, or an invalid handle if there isn't one. */
+    [[nodiscard]] MeshHandle find(std::string_view source) const;
+
+    [[nodiscard]] const MeshArena::drawRange &getDrawRange(MeshHandle handle) const { return mArena.get(handle); }
+
+    /**
+     * Sets whether meshes keep their CPU copy once they are on the GPU. Dropping them saves memory but means
+     * new meshes can only be matched against existing ones that still have their copy.
+     */
+    void setKeepCpuCopies(bool keep) { mKeepCpuCopies = keep; }
+
+    [[nodiscard]] MeshArena &getArena() { return mArena; }
+
+    /** @return The number of unique meshes. */
+    [[nodiscard]] size_t size() const { return mMeshes.size(); }
+
+protected:
+    static Bounds computeBounds(const PolygonalMesh &mesh);
+    static size_t hashContent(const PolygonalMesh &mesh);
+    static bool isContentEqual(const PolygonalMesh &lhs, const PolygonalMesh &rhs);
+
+    MeshArena mArena;
+    std::vector<PolygonalMesh> mMeshes;  // Indexed by MeshHandle::id.
+    std::vector<Bounds> mBounds;         // Indexed by MeshHandle::id.
+    std::vector<std::string> mSources;   // Indexed by MeshHandle::id.
+    std::unordered_map<std::string, MeshHandle> mSourceHandles;
+    std::unordered_multimap<size_t, MeshHandle> mContentHandles;
+    std::unordered_map<std::string, RegisteredModel> mModels;  // Keyed by path.
+    bool mKeepCpuCopies { true };
+};
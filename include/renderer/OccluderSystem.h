@@ -0,0 +1,20 @@
+#pragma once
+
+#include "System.h"
+#include "Components.h"
+#include "MeshRegistry.h"
+#include "OcclusionCuller.h"
+
+/**
+ * Rasterises every entity with an Occluder into the occlusion culler's depth buffer.
+ * @author Ryan Purse
+ */
+class OccluderSystem : public System
+{
+public:
+    /**
+     * Adds every occluder to culler, which must have already begun this frame. Occluders whose mesh has no CPU
+     * copy in meshRegistry are skipped.
+     */
+    void rasterize(OcclusionCuller &culler, const MeshRegistry &meshRegistry);
+};
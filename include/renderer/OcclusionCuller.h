@@ -0,0 +1,113 @@
+#pragma once
+
+#include <glm.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Finds entities that are hidden behind occluders on the CPU. Occluders are rasterised into a small depth buffer
+ * one tile at a time, with each row of a tile filled a batch of pixels at once: eight with AVX, four with SSE,
+ * otherwise one. The buffer is then reduced into a hierarchical depth (HiZ) mip chain so that an entity's bounding
+ * box only has to be compared against a handful of texels.
+ * Depths are stored like the GPU's depth buffer: 0 is the near plane and 1 is the far plane.
+ * @example culler.begin(vpMatrix); culler.addOccluder(mesh, model); ... culler.buildHiZ(); culler.isVisible(...);
+ * @author Ryan Purse
+ */
+class OcclusionCuller
+{
+public:
+    /** The number of pixels in a row that are filled by one instruction batch. */
+    static const size_t batchSize;
+
+    // The buffer's size is always rounded up to a whole number of tiles.
+    static constexpr int tileWidth { 8 };
+    static constexpr int tileHeight { 8 };
+
+    explicit OcclusionCuller(int width=256, int height=128);
+
+    void resize(int width, int height);
+
+    /** Clears the depth buffer to the far plane. Everything added afterwards is seen through vpMatrix. */
+    void begin(const glm::mat4 &vpMatrix);
+
+    /**
+     * Rasterises a triangle list into the depth buffer. Back faces are skipped, as are triangles that cross the
+     * near plane since they can't be projected. Both only mean that less is hidden.
+     */
+    void addOccluder(const std::vector<glm::vec3> &positions, const std::vector<unsigned int> &indices,
+                     const glm::mat4 &modelMatrix);
+
+    /** Same as above but reads the positions straight out of a mesh's vertices. */
+    template<typename Vertex>
+    void addOccluder(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices,
+                     const glm::mat4 &modelMatrix);
+
+    /** Reduces the depth buffer into the HiZ mip chain. Must be called after the last occluder is added. */
+    void buildHiZ();
+
+    /**
+     * @return False if a local space box is behind the occluders everywhere that it covers. Boxes that cross the
+     * near plane are always visible. Uses the HiZ mip chain, so may say that a hidden box is visible but never the
+     * other way around.
+     */
+    [[nodiscard]] bool isVisible(const glm::vec3 &min, const glm::vec3 &max, const glm::mat4 &modelMatrix) const;
+
+    /** The same test as isVisible() but checks every pixel that the box covers. Used to check the HiZ path. */
+    [[nodiscard]] bool isVisibleReference(const glm::vec3 &min, const glm::vec3 &max,
+                                          const glm::mat4 &modelMatrix) const;
+
+    [[nodiscard]] int getWidth() const { return mWidth; }
+    [[nodiscard]] int getHeight() const { return mHeight; }
+
+    /** @return The depth buffer, row by row from the bottom of the screen. */
+    [[nodiscard]] const std::vector<float> &getDepth() const { return mLevels[0].depth; }
+
+    [[nodiscard]] size_t getTriangleCount() const { return mTriangleCount; }
+
+protected:
+    /** One level of the HiZ mip chain. Each texel is the furthest depth of the four below it. */
+    struct level
+    {
+        int width;
+        int height;
+        std::vector<float> depth;
+    };
+
+    /** A box's footprint on the screen: an inclusive range of pixels and the nearest depth within it. */
+    struct screenRect
+    {
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+        float nearest;
+    };
+
+    enum class footprint { Offscreen, CrossesNearPlane, OnScreen };
+
+    /** Transforms mClipPositions into screen space and rasterises every triangle in indices. */
+    void rasterizeTriangles(const std::vector<unsigned int> &indices);
+
+    /** @param a, b, c Screen space positions with depth in z, wound counter-clockwise. */
+    void rasterizeTriangle(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c);
+
+    [[nodiscard]] footprint findFootprint(const glm::vec3 &min, const glm::vec3 &max, const glm::mat4 &modelMatrix,
+                                          screenRect &rect) const;
+
+    std::vector<level> mLevels;  // mLevels[0] is the depth buffer.
+    std::vector<glm::vec4> mClipPositions;
+    glm::mat4 mVpMatrix { 1.f };
+    int mWidth { 0 };
+    int mHeight { 0 };
+    size_t mTriangleCount { 0 };
+};
+
+template<typename Vertex>
+void OcclusionCuller::addOccluder(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices,
+                                  const glm::mat4 &modelMatrix)
+{
+    const glm::mat4 mvpMatrix = mVpMatrix * modelMatrix;
+    mClipPositions.clear();
+    for (const Vertex &vertex : vertices) { mClipPositions.push_back(mvpMatrix * glm::vec4(vertex.position, 1.f)); }
+    rasterizeTriangles(indices);
+}
@@ -1,22 +1,57 @@
 #pragma once
 
 #include "System.h"
+#include "Components.h"
 #include "Shader.h"
 
 #include <glm.hpp>
+#include <array>
 #include <vector>
 
 /**
- * [Description goes here.]
+ * Sends every point light and the camera's position to the shader. Lights are gathered from their components first
+ * so that setting the uniforms is only GL work.
  * @author Ryan Purse
  */
 class PointLightTransformer : public System
 {
 public:
-    void setShaderLights(ecs::entity mainCamera, Shader &shader);
-    void calculateLightPositions(Shader &shader);
+    /** The length of u_lights in Basic.shader. */
+    static constexpr size_t maxLights { 32 };
+
+    /** Finds the uniforms that the lights are written to. Must be called before setShaderLights(). */
+    void init(const Shader &shader);
+
+    /** Copies the camera's position and every light that the shader can read out of their components. */
+    void gatherLights(ecs::entity mainCamera);
+
+    /** Sends the lights from the last gatherLights() to the shader. */
+    void setShaderLights(const Shader &shader) const;
 protected:
+    struct lightValues
+    {
+        glm::vec4 positionWs;
+        glm::vec4 colour;
+        float intensity;
+        float fallOff;
+    };
+
+    struct lightUniforms
+    {
+        UniformHandle<glm::vec4> positionWs;
+        UniformHandle<glm::vec4> colour;
+        UniformHandle<float> intensity;
+        UniformHandle<float> fallOff;
+    };
+
+    std::array<lightUniforms, maxLights> mLightUniforms;
+    std::array<lightValues, maxLights> mLights { };
+    size_t mLightCount { 0 };
+    glm::vec4 mCameraPosition { 0.f };
 
+    // Only the lights that the shader reads are active. Lights past this are ignored.
+    size_t mActiveLights { 0 };
+    UniformHandle<glm::vec4> mCameraPositionWs;
 };
 
 
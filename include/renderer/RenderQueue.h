@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Draws waiting to be submitted, each with a 64-bit sort key. Sorting puts every opaque draw before every
+ * transparent one. Opaque draws are grouped by shader, texture arrays and batch (mesh and materials) so that state
+ * changes as little as possible, and then go front to back. Transparent draws go back to front before anything else
+ * so that they blend correctly.
+ * Keys are sorted with a least significant digit radix sort, a byte at a time. Bytes that are the same in every key
+ * are skipped, so most frames only need a few passes.
+ * @example queue.add(RenderQueue::makeKey(pass, shader, textures, batch, depth), instance); queue.sort();
+ * @author Ryan Purse
+ */
+class RenderQueue
+{
+public:
+    enum class pass : uint8_t { Opaque, Transparent };
+
+    // The width of each field in a key. Callers must keep their ids below 1 << bits.
+    static constexpr int shaderBits { 4 };
+    static constexpr int texturesBits { 12 };
+    static constexpr int batchBits { 22 };
+    static constexpr int depthBits { 24 };
+
+    struct item
+    {
+        uint64_t key;
+        unsigned int instance;
+    };
+
+    /**
+     * Opaque keys are laid out as pass | shader | textures | batch | depth. Transparent keys move the depth,
+     * inverted, to just after the pass.
+     * @param depth The distance in front of the camera. Negative depths are treated as zero.
+     */
+    static uint64_t makeKey(pass renderPass, unsigned int shader, unsigned int textures, unsigned int batch,
+                            float depth);
+
+    static pass getPass(uint64_t key) { return static_cast<pass>(key >> 62); }
+    static unsigned int getShader(uint64_t key);
+    static unsigned int getTextures(uint64_t key);
+    static unsigned int getBatch(uint64_t key);
+
+    /** @return key with its texture arrays and batch ids replaced. Used to swap local ids for shared ones. */
+    static uint64_t replaceIds(uint64_t key, unsigned int textures, unsigned int batch);
+
+    /** @return The same state as key without the depth, so draws that only differ by depth compare equal. */
+    static uint64_t getState(uint64_t key);
+
+    void add(uint64_t key, unsigned int instance) { mItems.push_back({ key, instance }); }
+
+    /** Removes every item. Memory is kept for the next frame. */
+    void clear() { mItems.clear(); }
+
+    /** Makes room for size items so that several threads can fill the queue at once with set(). */
+    void resize(size_t size) { mItems.resize(size); }
+
+    void set(size_t index, uint64_t key, unsigned int instance) { mItems[index] = { key, instance }; }
+
+    /** Sorts the items by key. Items with the same key stay in the order that they were added. */
+    void sort();
+
+    [[nodiscard]] const std::vector<item> &getItems() const { return mItems; }
+    [[nodiscard]] size_t size() const { return mItems.size(); }
+
+    /** @return The number of byte passes that the last sort() needed. */
+    [[nodiscard]] int getLastSortPasses() const { return mLastSortPasses; }
+
+protected:
+    std::vector<item> mItems;
+    std::vector<item> mScratch;
+    int mLastSortPasses { 0 };
+};
@@ -1,35 +1,271 @@
 #pragma once
 
 #include "System.h"
+#include "Components.h"
 #include "Shader.h"
 #include "MaterialProcessor.h"
 #include "PointLightTransformer.h"
+#include "MeshRegistry.h"
+#include "StreamBuffer.h"
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+#include "OccluderSystem.h"
+#include "SpatialSystem.h"
+#include "FrameGraph.h"
 
 #include <glm.hpp>
 #include <gtc/matrix_transform.hpp>
 #include <gtx/quaternion.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 
 /**
- * Handles rendering entities who have a mesh and transform component.
+ * Handles rendering entities who have a mesh, bounds and transform component. Entities outside of the camera's
+ * frustum or hidden behind an occluder are culled. The rest are ordered by a RenderQueue: opaque entities front to
+ * back with blending off, and then transparent ones back to front. Neighbouring entities that share a mesh and
+ * materials are drawn as instances of one indirect draw, and neighbouring draws that share textures are submitted
+ * with a single glMultiDrawElementsIndirect().
+ * Draw lists are built in two stages. Workers from the thread pool each turn a chunk of the visible entities into
+ * render packets in their own list. The lists are then merged and sorted, and the instances and indirect commands
+ * are laid out from the packets. Everything up to here happens before any GL call.
+ * The GPU work is split into passes in a FrameGraph: the draw lists are uploaded, drawn into a transient colour and
+ * depth texture, and then presented to the backbuffer.
  * @author Ryan Purse
  */
 class RendererSystem : public System
 {
 public:
     RendererSystem();
+    /**
+     * Finds the shader's uniforms and builds the frame graph. Must be called once mMaterialProcessor and
+     * mPointLightTransformer are set.
+     */
+    void init();
     void setMainCamera(ecs::entity entity);
-    void render();
+
+    /** @param resolution The size of the backbuffer. The frame graph's textures are resized to match. */
+    void render(const glm::ivec2 &resolution);
     std::shared_ptr<MaterialProcessor> mMaterialProcessor;
     std::shared_ptr<PointLightTransformer> mPointLightTransformer;
+
+    /** Finds the visible entities if set. Otherwise every entity's bounds are tested by mFrustumCuller. */
+    std::shared_ptr<SpatialSystem> mSpatialSystem;
+
+    /** Occlusion culling is skipped if this isn't set or has no entities. */
+    std::shared_ptr<OccluderSystem> mOccluderSystem;
+    MeshRegistry mMeshRegistry;
+
+    /** @return The bytes of mesh data that were sent to the GPU during the last render. */
+    [[nodiscard]] size_t getMeshUploadBytes() const { return mMeshUploadBytes; }
+
+    /** @return The number of indirect draws in the last render. Each one may draw many instances. */
+    [[nodiscard]] size_t getDrawCount() const { return mCommands.size(); }
+
+    [[nodiscard]] size_t getInstanceCount() const { return mInstances.size(); }
+
+    /** @return The number of instances that were drawn in the transparent pass. */
+    [[nodiscard]] size_t getTransparentCount() const { return mTransparentCount; }
+
+    /** @return The number of entities whose bounds were tested against the frustum in the last render. */
+    [[nodiscard]] size_t getTestedCount() const { return mTestedCount; }
+
+    /** @return The number of tested entities that were outside of the frustum. */
+    [[nodiscard]] size_t getCulledCount() const { return mCulledCount; }
+
+    /** @return The number of entities inside of the frustum that were culled by mOcclusionCuller. */
+    [[nodiscard]] size_t getOccludedCount() const { return mOccludedCount; }
+
+    [[nodiscard]] const FrameGraph &getFrameGraph() const { return mFrameGraph; }
 protected:
-    void computeModels();
-    void setTextures(const TextureIds& textures) const;
-    unsigned int mVertexBufferId{};
-    unsigned int mVertexArrayId{};
-    unsigned int mIndexBufferId{};
-    unsigned int mCurrentTexturesId{};
+    /** Matches DrawElementsIndirectCommand in the OpenGL spec. */
+    struct drawElementsIndirectCommand
+    {
+        unsigned int count;
+        unsigned int instanceCount;
+        unsigned int firstIndex;
+        int baseVertex;
+        unsigned int baseInstance;
+    };
+
+    /**
+     * Per instance data read by Basic.shader through gl_BaseInstanceARB + gl_InstanceID. Laid out as std430.
+     */
+    struct instanceData
+    {
+        glm::mat4 modelMatrix;
+        unsigned int materialOffset;
+        unsigned int padding[3] { };
+    };
+
+    /** Everything needed to draw one entity. */
+    struct renderPacket
+    {
+        uint64_t key;  // Only has its texture arrays and batch ids once the lists are merged.
+        unsigned int textures;  // The list's local ids.
+        unsigned int batch;
+        MeshArena::drawRange range;
+        instanceData instance;
+    };
+
+    /** Gives each distinct value a small id so that it fits into a sort key. Ids are never given back. */
+    struct idTable
+    {
+        std::unordered_map<uint64_t, unsigned int> ids;
+        std::vector<uint64_t> values;  // values[id] gives back the value.
+
+        unsigned int find(uint64_t value);
+        void clear();
+    };
+
+    /**
+     * Ids that belong to one packet list so that workers never share a table. Each is mapped to an id in a shared
+     * table. The mapping is kept between frames, so only ids that haven't been shared yet are queued for merging.
+     */
+    struct localIdTable
+    {
+        static constexpr unsigned int unshared { std::numeric_limits<unsigned int>::max() };
+        static constexpr unsigned int queued { unshared - 1 };
+
+        idTable local;
+        std::vector<unsigned int> shared;  // shared[id] is the id's value in the shared table.
+        std::vector<unsigned int> queue;
+
+        /** @return The local id of value. Queues it if it hasn't been shared. */
+        unsigned int find(uint64_t value);
+
+        /** Queues id if it hasn't been shared. */
+        void use(unsigned int id);
+
+        /** Gives every queued id a shared id from table. */
+        void share(idTable &table);
+
+        /** Forgets every shared id. Used when table has been cleared. */
+        void unshare();
+
+        void clear();
+    };
+
+    /** The packets built for one chunk of the visible entities. */
+    struct packetList
+    {
+        std::vector<renderPacket> packets;
+        size_t occludedCount { 0 };
+        size_t first { 0 };  // Where the packets start once the lists are merged.
+
+        localIdTable textures;
+        localIdTable batches;
+    };
+
+    /** A run of draws in the same pass that share the same textures, so can be drawn with a single call. */
+    struct drawBucket
+    {
+        RenderQueue::pass renderPass;
+        unsigned int diffuseTexturesId;
+        unsigned int normalMapId;
+        unsigned int first;
+        unsigned int count;
+    };
+
+    /** Adds the upload, forward and present passes. */
+    void buildFrameGraph();
+
+    /** Draws every bucket. Blending is turned on for the transparent ones. */
+    void drawBuckets() const;
+
+    /** Fills the instance and command lists from every visible entity, sorted into buckets. */
+    void buildDrawLists(const glm::mat4 &vpMatrix);
+
+    /** Builds a packet for each of mVisibleEntities[begin, end) that isn't occluded. Run by the workers. */
+    void buildPackets(packetList &list, size_t begin, size_t end, const glm::mat4 &vpMatrix, bool occlusion);
+
+    /** Swaps every list's local ids for shared ones and copies the packets into mPackets and mRenderQueue. */
+    void mergePackets(size_t listCount);
+
+    /**
+     * Shares every list's queued ids in table. If table would run out of bits in the sort keys, it is cleared and
+     * only the ids that this frame's packets use are shared again.
+     */
+    void shareIds(idTable &table, localIdTable packetList::*ids, unsigned int renderPacket::*packetId, int bits,
+                  size_t listCount);
+
+    /** Lays out mInstances, mCommands and mBuckets from the sorted packets. */
+    void buildCommands();
+
+    /** @return How many chunks count items are split into. One if there are too few to be worth sharing out. */
+    [[nodiscard]] size_t findChunkCount(size_t count) const;
+
+    /** Calls func(chunk, begin, end) for each of chunkCount even chunks of [0, count) across the thread pool. */
+    template<typename Func>
+    void parallelForChunks(size_t count, size_t chunkCount, Func &&func) const
+    {
+        const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+        auto runChunk = [&](size_t chunk) {
+            func(chunk, std::min(count, chunk * chunkSize), std::min(count, (chunk + 1) * chunkSize));
+        };
+
+        ThreadPool *threadPool = getThreadPool();
+        if (!threadPool || chunkCount == 1)
+        {
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk) { runChunk(chunk); }
+            return;
+        }
+        threadPool->parallelFor(chunkCount, runChunk);
+    }
+
+    /** Fills mVisibleEntities with everything that mSpatialSystem finds inside of the frustum. */
+    void gatherFromSpatialSystem(const glm::mat4 &vpMatrix);
+
+    /** Fills mVisibleEntities with every entity that passes mFrustumCuller. */
+    void gatherByCulling(const glm::mat4 &vpMatrix);
+
+    /** @return False if there are no occluders, so nothing can be hidden. */
+    bool rasterizeOccluders(const glm::mat4 &vpMatrix);
+
+    /** @param depth The distance from the camera to the entity's bounds along the view direction. */
+    void addPacket(packetList &list, const MeshHandle &meshHandle, const RendererUniforms &uniforms,
+                   const WorldTransform &world, float depth);
+
+    size_t mMeshUploadBytes{};
+    size_t mTestedCount{};
+    size_t mCulledCount{};
+    size_t mOccludedCount{};
+    size_t mTransparentCount{};
+
+    // Kept between frames so that their memory is reused.
+    std::vector<ecs::entity> mCandidates;
+    std::vector<ecs::entity> mVisibleEntities;
+    std::vector<packetList> mPacketLists;
+    std::vector<renderPacket> mPackets;
+    RenderQueue mRenderQueue;
+    std::vector<instanceData> mInstances;
+    std::vector<drawElementsIndirectCommand> mCommands;
+    std::vector<drawBucket> mBuckets;
+
+    // The texture arrays (diffuse << 32 | normal) and batches (mesh << 32 | material offset) in sort keys.
+    idTable mTextures;
+    idTable mBatches;
+
+    FrustumCuller mFrustumCuller;
+    OcclusionCuller mOcclusionCuller;
+
+    StreamBuffer mInstanceBuffer;
+    StreamBuffer mCommandBuffer;
+
+    FrameGraph mFrameGraph;
+    unsigned int mPresentFramebuffer { 0 };  // Reads the scene colour texture when it is blitted to the backbuffer.
+
+    // Copied out of the camera before the frame graph runs so that its passes only make GL calls.
+    glm::mat4 mVpMatrix { 1.f };
+    glm::mat4 mViewMatrix { 1.f };
+
+    UniformHandle<glm::mat4> mVpMatrixUniform;
+    UniformHandle<glm::mat4> mViewMatrixUniform;
 
     ecs::entity mMainCamera{};
 };
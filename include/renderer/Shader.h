@@ -19,6 +19,19 @@ struct shaderProgramSource
     std::string fragmentSource;
 };
 
+/**
+ * The location of a uniform, found once with Shader::getUniform() so that setting it each frame needs no lookups.
+ * T is the type that the uniform is set with.
+ * @author Ryan Purse
+ */
+template<typename T>
+struct UniformHandle
+{
+    int location { -1 };
+
+    [[nodiscard]] bool isValid() const { return location != -1; }
+};
+
 /**
  * [Description goes here.]
  * [Initial Version: 04/06/2021]
@@ -27,9 +40,17 @@ struct shaderProgramSource
 class Shader
 {
 private:
+    /** An active uniform as reported by the program after linking. */
+    struct uniformInfo
+    {
+        int location;
+        unsigned int type;
+        int arraySize;
+    };
+
     std::string mFilePath;  // This is for debug purposes
     unsigned int mRendererId;
-    std::unordered_map<std::string, int> mUniformLocationCache;
+    std::unordered_map<std::string, uniformInfo> mUniforms;
 
 public:
     explicit Shader(const std::string &filepath);
@@ -38,22 +59,39 @@ public:
     void bind() const;
     static void unBind();
 
-    // Set uniforms
-    void setUniform(const std::string &name, const glm::vec3 &values, int count);
-    void setUniform(const std::string &name, const float *values, int count);
-    void setUniform(const std::string &name, const int *values, int count);
-    void setUniform(const std::string &name, int value);
-    void setUniform(const std::string &name, float value);
-    void setUniform(const std::string &name, const glm::vec2 &value);
-    void setUniform(const std::string &name, const glm::vec3 &value);
-    void setUniform(const std::string &name, const glm::vec4 &vec4);
-    void setUniform(const std::string &name, const glm::mat4 &mat4);
+    /**
+     * Finds a uniform by name. Arrays can be named with or without [0]. Logs a warning and returns an invalid
+     * handle, which is ignored when set, if the uniform doesn't exist or isn't a T.
+     * @example const auto colour = shader.getUniform<glm::vec4>("u_lights[2].colour");
+     */
+    template<typename T>
+    [[nodiscard]] UniformHandle<T> getUniform(const std::string &name) const;
+
+    /** @return False if the uniform was never declared or the compiler removed it because it is never used. */
+    [[nodiscard]] bool hasUniform(const std::string &name) const;
+
+    // Set uniforms. The shader must be bound.
+    void setUniform(UniformHandle<glm::vec3> handle, const glm::vec3 *values, int count) const;
+    void setUniform(UniformHandle<float> handle, const float *values, int count) const;
+    void setUniform(UniformHandle<int> handle, const int *values, int count) const;
+    void setUniform(UniformHandle<int> handle, int value) const;
+    void setUniform(UniformHandle<unsigned int> handle, unsigned int value) const;
+    void setUniform(UniformHandle<float> handle, float value) const;
+    void setUniform(UniformHandle<glm::vec2> handle, const glm::vec2 &value) const;
+    void setUniform(UniformHandle<glm::vec3> handle, const glm::vec3 &value) const;
+    void setUniform(UniformHandle<glm::vec4> handle, const glm::vec4 &vec4) const;
+    void setUniform(UniformHandle<glm::mat4> handle, const glm::mat4 &mat4) const;
 
 private:
     static shaderProgramSource parseShader(const std::string &filepath);
     static unsigned int createShader(const std::string &vertexShader, const std::string &fragmentShader);
     static unsigned int compileShader(unsigned int type, const std::string &source);
-    int getUniformLocation(const std::string &name);
-};
 
+    /** Fills mUniforms with every uniform that isn't part of a block. */
+    void reflectUniforms();
+
+    [[nodiscard]] std::unordered_map<std::string, uniformInfo>::const_iterator find(const std::string &name) const;
 
+    /** @return The uniform's location, or -1 if it doesn't exist or isn't of type expectedType. */
+    int findUniform(const std::string &name, unsigned int expectedType) const;
+};
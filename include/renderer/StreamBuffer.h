@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * A GPU buffer whose contents are replaced every frame, such as per draw data. The old storage is orphaned on
+ * each upload so that the driver doesn't have to wait for last frame's draws to finish with it.
+ * @author Ryan Purse
+ */
+class StreamBuffer
+{
+public:
+    StreamBuffer();
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+    template<typename T>
+    void upload(const std::vector<T> &data)
+    {
+        upload(data.data(), data.size() * sizeof(T));
+    }
+
+    /** Replaces the buffer's contents. Grows the buffer if data doesn't fit. */
+    void upload(const void *data, size_t size);
+
+    /** Binds the buffer to an indexed target such as GL_SHADER_STORAGE_BUFFER. */
+    void bindBase(unsigned int target, unsigned int index) const;
+
+    void bind(unsigned int target) const;
+
+    [[nodiscard]] unsigned int getId() const { return mId; }
+
+protected:
+    unsigned int mId        { 0 };
+    size_t mCapacity        { 0 };
+};
@@ -1,5 +1,6 @@
 #shader vertex
-#version 460 core
+#version 450 core
+#extension GL_ARB_shader_draw_parameters : require
 
 //     ws - World Space.
 //     ts - Tangent Space.
@@ -20,17 +21,29 @@ out      vec4 v_vertex_position_ts;
 out      vec4 v_vertex_position_ws;
 out      vec4 v_camera_position_ts;
 out      mat4 v_tbn_matrix;
+out flat uint v_material_offset;
 
-uniform mat4 u_mvp_matrix;
+// One per instance. Must match RendererSystem::instanceData.
+struct InstanceData
+{
+    mat4 model_matrix;
+    uint material_offset;
+};
+
+layout(std430, binding = 0) readonly buffer InstanceBuffer
+{
+    InstanceData u_instances[];
+};
+
+uniform mat4 u_vp_matrix;
 uniform mat4 u_view_matrix;
-uniform mat4 u_model_matrix;
 
 uniform vec4 u_camera_position_ws;
 
 
-mat4 create_tbn_matrix()
+mat4 create_tbn_matrix(mat4 model_matrix)
 {
-    const mat4 mv_matrix = u_view_matrix * u_model_matrix;
+    const mat4 mv_matrix = u_view_matrix * model_matrix;
 
     const vec4 normal_cs     = mv_matrix * vec4(normalize(normal.xyz),     0.0);
     const vec4 tangent_cs    = mv_matrix * vec4(normalize(tangent.xyz),    0.0);
@@ -47,21 +60,25 @@ mat4 create_tbn_matrix()
 
 void main()
 {
-    v_texture_coord = texture_coord;
-    f_texture_id    = texture_id;
+    // gl_InstanceID does not include the draw's baseInstance, so it is added back on here.
+    const InstanceData instance = u_instances[gl_BaseInstanceARB + gl_InstanceID];
 
-    v_tbn_matrix = create_tbn_matrix();
+    v_texture_coord   = texture_coord;
+    f_texture_id      = texture_id;
+    v_material_offset = instance.material_offset;
 
-    v_vertex_position_ts = v_tbn_matrix * u_view_matrix * u_model_matrix * position;
-    v_vertex_position_ws = u_model_matrix * position;
+    v_tbn_matrix = create_tbn_matrix(instance.model_matrix);
+
+    v_vertex_position_ts = v_tbn_matrix * u_view_matrix * instance.model_matrix * position;
+    v_vertex_position_ws = instance.model_matrix * position;
     v_camera_position_ts = v_tbn_matrix * u_view_matrix * u_camera_position_ws;
 
-    gl_Position = u_mvp_matrix * position;
+    gl_Position = u_vp_matrix * v_vertex_position_ws;
 }
 
 
 #shader fragment
-#version 460 core
+#version 450 core
 
 
 struct PointLight
@@ -78,6 +95,7 @@ struct Material
     vec4  k_diffuse;
     vec4  k_specular;
     float n_specular;
+    float dissolve;
 };
 
 
@@ -87,15 +105,23 @@ in      vec4 v_vertex_position_ts;
 in      vec4 v_vertex_position_ws;
 in      vec4 v_camera_position_ts;
 in      mat4 v_tbn_matrix;
+in flat uint v_material_offset;
+
+out vec4 o_colour;
+
+// Every material, indexed by material id. Must match MaterialPool::gpuMaterial.
+layout(std430, binding = 1) readonly buffer MaterialBuffer
+{
+    Material u_materials[];
+};
 
 
-uniform sampler2DArray u_diffuse_map_textures;
-uniform sampler2DArray u_normal_map_textures;
+layout(binding = 0) uniform sampler2DArray u_diffuse_map_textures;
+layout(binding = 1) uniform sampler2DArray u_normal_map_textures;
 
 uniform mat4 u_view_matrix;
 
 uniform PointLight u_lights    [32];
-uniform Material   u_materials [32];
 
 vec4 get_light_intensity(PointLight light)
 {
@@ -117,7 +143,7 @@ float calculate_diffuse_power(vec4 light_direction_ts, vec4 texture_normal_ts)
 
 float calculate_specular_power(vec4 light_direction_ts, vec4 texture_normal_ts)
 {
-    const float exponent = u_materials[f_texture_id].n_specular;
+    const float exponent = u_materials[v_material_offset + f_texture_id].n_specular;
     if (exponent <= 0.0) { return 0; }
 
     const vec4 view_direction_ts  = vec4(normalize(v_camera_position_ts.xyz - v_vertex_position_ts.xyz), 0.0);
@@ -149,11 +175,15 @@ void main()
 
     vec4 k_diffuse_texture_colour = texture(u_diffuse_map_textures, vec3(v_texture_coord, f_texture_id));
 
-    vec4 k_base_ambient  = u_materials[f_texture_id].k_ambient;
-    vec4 k_base_diffuse  = u_materials[f_texture_id].k_diffuse;
-    vec4 k_base_specular = u_materials[f_texture_id].k_specular;
+    const Material material = u_materials[v_material_offset + f_texture_id];
+    vec4 k_base_ambient  = material.k_ambient;
+    vec4 k_base_diffuse  = material.k_diffuse;
+    vec4 k_base_specular = material.k_specular;
 
-    gl_FragColor = k_base_ambient  * k_light_ambient  * k_diffuse_texture_colour +
+    o_colour = k_base_ambient  * k_light_ambient  * k_diffuse_texture_colour +
                    k_base_diffuse  * k_light_diffuse  * k_diffuse_texture_colour +
                    k_base_specular * k_light_specular;
+
+    // Only read by the transparent pass. Opaque draws are not blended.
+    o_colour.a = k_diffuse_texture_colour.a * material.dissolve;
 }
@@ -0,0 +1,385 @@
+/**
+ * @file AabbTree.cpp
+ * @brief A bounding volume hierarchy that is kept balanced with tree rotations as boxes move.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "AabbTree.h"
+
+#include <algorithm>
+#include <limits>
+
+AabbTree::AabbTree(float margin)
+    : mMargin(margin)
+{
+}
+
+int AabbTree::insert(const aabb &box, uint64_t userData)
+{
+    const int leaf = insertUnlinked(box, userData);
+    insertLeaf(leaf);
+    return leaf;
+}
+
+int AabbTree::insertUnlinked(const aabb &box, uint64_t userData)
+{
+    const int leaf = allocateNode();
+    node &leafNode = mNodes[leaf];
+    leafNode.box = { box.min - glm::vec3(mMargin), box.max + glm::vec3(mMargin) };
+    leafNode.userData = userData;
+    leafNode.height = 0;
+    ++mLeafCount;
+    return leaf;
+}
+
+void AabbTree::remove(int proxy)
+{
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --mLeafCount;
+}
+
+bool AabbTree::move(int proxy, const aabb &box)
+{
+    const aabb fatBox { box.min - glm::vec3(mMargin), box.max + glm::vec3(mMargin) };
+    node &leaf = mNodes[proxy];
+
+    // A fat box that has grown far past the object, after a refit, is shrunk back down.
+    const aabb largestAllowed { box.min - glm::vec3(4.f * mMargin), box.max + glm::vec3(4.f * mMargin) };
+    if (contains(leaf.box, box) && contains(largestAllowed, leaf.box)) { return false; }
+
+    if (overlaps(leaf.box, fatBox))
+    {
+        leaf.box = fatBox;
+        refitUpwards(leaf.parent);
+    }
+    else
+    {
+        removeLeaf(proxy);
+        mNodes[proxy].box = fatBox;
+        insertLeaf(proxy);
+    }
+    return true;
+}
+
+void AabbTree::clear()
+{
+    mNodes.clear();
+    mRoot = nullNode;
+    mFreeList = nullNode;
+    mLeafCount = 0;
+}
+
+float AabbTree::getAreaRatio() const
+{
+    if (mRoot == nullNode) { return 0.f; }
+
+    float total = 0.f;
+    for (const node &current : mNodes)
+    {
+        if (current.height > 0) { total += area(current.box); }
+    }
+    const float rootArea = area(mNodes[mRoot].box);
+    return rootArea > 0.f ? total / rootArea : 0.f;
+}
+
+bool AabbTree::overlaps(const aabb &lhs, const aabb &rhs)
+{
+    return glm::all(glm::lessThanEqual(lhs.min, rhs.max)) && glm::all(glm::lessThanEqual(rhs.min, lhs.max));
+}
+
+bool AabbTree::contains(const aabb &outer, const aabb &inner)
+{
+    return glm::all(glm::lessThanEqual(outer.min, inner.min)) && glm::all(glm::lessThanEqual(inner.max, outer.max));
+}
+
+float AabbTree::area(const aabb &box)
+{
+    const glm::vec3 size = box.max - box.min;
+    return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+int AabbTree::allocateNode()
+{
+    if (mFreeList == nullNode)
+    {
+        mNodes.emplace_back();
+        return static_cast<int>(mNodes.size() - 1);
+    }
+
+    const int index = mFreeList;
+    mFreeList = mNodes[index].parent;
+    mNodes[index] = node();
+    return index;
+}
+
+void AabbTree::freeNode(int index)
+{
+    mNodes[index].parent = mFreeList;
+    mNodes[index].height = -1;
+    mFreeList = index;
+}
+
+void AabbTree::insertLeaf(int leaf)
+{
+    if (mRoot == nullNode)
+    {
+        mRoot = leaf;
+        mNodes[leaf].parent = nullNode;
+        return;
+    }
+
+    // Walks down to the sibling that adds the least area, counting the growth of every ancestor on the way.
+    const aabb leafBox = mNodes[leaf].box;
+    int index = mRoot;
+    while (!mNodes[index].isLeaf())
+    {
+        const node &current = mNodes[index];
+        const float currentArea = area(current.box);
+        const float combinedArea = area(combine(current.box, leafBox));
+
+        const float cost = 2.f * combinedArea;
+        const float inheritanceCost = 2.f * (combinedArea - currentArea);
+
+        const auto childCost = [&](int child) {
+            const node &childNode = mNodes[child];
+            const float newArea = area(combine(leafBox, childNode.box));
+            return (childNode.isLeaf() ? newArea : newArea - area(childNode.box)) + inheritanceCost;
+        };
+        const float cost1 = childCost(current.child1);
+        const float cost2 = childCost(current.child2);
+
+        if (cost < cost1 && cost < cost2) { break; }
+        index = cost1 < cost2 ? current.child1 : current.child2;
+    }
+
+    const int sibling = index;
+    const int oldParent = mNodes[sibling].parent;
+    const int newParent = allocateNode();
+    node &parentNode = mNodes[newParent];
+    parentNode.parent = oldParent;
+    parentNode.box = combine(leafBox, mNodes[sibling].box);
+    parentNode.height = mNodes[sibling].height + 1;
+    parentNode.child1 = sibling;
+    parentNode.child2 = leaf;
+    mNodes[sibling].parent = newParent;
+    mNodes[leaf].parent = newParent;
+
+    if (oldParent == nullNode) { mRoot = newParent; }
+    else if (mNodes[oldParent].child1 == sibling) { mNodes[oldParent].child1 = newParent; }
+    else { mNodes[oldParent].child2 = newParent; }
+
+    refitUpwards(oldParent);
+}
+
+void AabbTree::removeLeaf(int leaf)
+{
+    if (leaf == mRoot)
+    {
+        mRoot = nullNode;
+        return;
+    }
+
+    const int parent = mNodes[leaf].parent;
+    const int grandParent = mNodes[parent].parent;
+    const int sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+    mNodes[sibling].parent = grandParent;
+    freeNode(parent);
+    if (grandParent == nullNode)
+    {
+        mRoot = sibling;
+        return;
+    }
+
+    if (mNodes[grandParent].child1 == parent) { mNodes[grandParent].child1 = sibling; }
+    else { mNodes[grandParent].child2 = sibling; }
+    refitUpwards(grandParent);
+}
+
+void AabbTree::refitUpwards(int index)
+{
+    while (index != nullNode)
+    {
+        rotate(index);
+
+        node &current = mNodes[index];
+        const node &child1 = mNodes[current.child1];
+        const node &child2 = mNodes[current.child2];
+        current.box = combine(child1.box, child2.box);
+        current.height = 1 + std::max(child1.height, child2.height);
+        index = current.parent;
+    }
+}
+
+void AabbTree::rotate(int index)
+{
+    node &current = mNodes[index];
+    if (current.height < 2) { return; }
+
+    // Moving child x down into its sibling y, in place of one of y's children, only changes y's box.
+    // Each candidate is scored by how much smaller y becomes.
+    int bestMoved = nullNode;
+    int bestReplaced = nullNode;
+    float bestImprovement = 0.f;
+    const auto consider = [&](int moved, int other) {
+        const node &otherNode = mNodes[other];
+        if (otherNode.isLeaf()) { return; }
+
+        const float otherArea = area(otherNode.box);
+        const node &movedNode = mNodes[moved];
+        const float replaceFirst = otherArea - area(combine(movedNode.box, mNodes[otherNode.child2].box));
+        const float replaceSecond = otherArea - area(combine(movedNode.box, mNodes[otherNode.child1].box));
+        if (replaceFirst > bestImprovement)
+        {
+            bestImprovement = replaceFirst;
+            bestMoved = moved;
+            bestReplaced = otherNode.child1;
+        }
+        if (replaceSecond > bestImprovement)
+        {
+            bestImprovement = replaceSecond;
+            bestMoved = moved;
+            bestReplaced = otherNode.child2;
+        }
+    };
+    consider(current.child1, current.child2);
+    consider(current.child2, current.child1);
+    if (bestMoved == nullNode) { return; }
+
+    const int other = mNodes[bestReplaced].parent;
+    node &otherNode = mNodes[other];
+    if (current.child1 == bestMoved) { current.child1 = bestReplaced; }
+    else { current.child2 = bestReplaced; }
+    if (otherNode.child1 == bestReplaced) { otherNode.child1 = bestMoved; }
+    else { otherNode.child2 = bestMoved; }
+
+    mNodes[bestReplaced].parent = index;
+    mNodes[bestMoved].parent = other;
+
+    const node &kept = mNodes[otherNode.child1 == bestMoved ? otherNode.child2 : otherNode.child1];
+    otherNode.box = combine(mNodes[bestMoved].box, kept.box);
+    otherNode.height = 1 + std::max(mNodes[bestMoved].height, kept.height);
+}
+
+void AabbTree::rebuild()
+{
+    std::vector<buildItem> items;
+    items.reserve(mLeafCount);
+    for (int i = 0; i < static_cast<int>(mNodes.size()); ++i)
+    {
+        const node &current = mNodes[i];
+        if (current.height == 0) { items.push_back({ current.box, (current.box.min + current.box.max) * 0.5f, i }); }
+        else if (current.height > 0) { freeNode(i); }
+    }
+
+    mRoot = items.empty() ? nullNode : buildRange(items.data(), items.size(), nullNode);
+}
+
+int AabbTree::buildRange(buildItem *items, size_t count, int parent)
+{
+    if (count == 1)
+    {
+        mNodes[items[0].leaf].parent = parent;
+        return items[0].leaf;
+    }
+
+    aabb centres { items[0].centre, items[0].centre };
+    for (size_t i = 1; i < count; ++i)
+    {
+        centres = { glm::min(centres.min, items[i].centre), glm::max(centres.max, items[i].centre) };
+    }
+
+    // Items are put into bins by their centre along each axis and the split between bins with the lowest
+    // area * count on either side wins.
+    constexpr int binCount = 16;
+    const auto binOf = [&centres](const buildItem &item, int axis, float scale) {
+        return std::min(binCount - 1, static_cast<int>((item.centre[axis] - centres.min[axis]) * scale));
+    };
+
+    int bestAxis = -1;
+    int bestSplit = 0;
+    float bestCost = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const float extent = centres.max[axis] - centres.min[axis];
+        if (extent <= std::numeric_limits<float>::epsilon()) { continue; }
+
+        std::array<aabb, binCount> binBoxes;
+        std::array<size_t, binCount> binCounts { };
+        const float scale = binCount / extent;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const int bin = binOf(items[i], axis, scale);
+            binBoxes[bin] = binCounts[bin] == 0 ? items[i].box : combine(binBoxes[bin], items[i].box);
+            ++binCounts[bin];
+        }
+
+        // Costs of splitting after each bin, swept from the right and then from the left.
+        std::array<float, binCount - 1> rightCosts { };
+        aabb rightBox;
+        size_t rightCount = 0;
+        for (int bin = binCount - 1; bin > 0; --bin)
+        {
+            if (binCounts[bin] > 0)
+            {
+                rightBox = rightCount == 0 ? binBoxes[bin] : combine(rightBox, binBoxes[bin]);
+                rightCount += binCounts[bin];
+            }
+            rightCosts[bin - 1] = rightCount == 0 ? 0.f : area(rightBox) * static_cast<float>(rightCount);
+        }
+
+        aabb leftBox;
+        size_t leftCount = 0;
+        for (int bin = 0; bin < binCount - 1; ++bin)
+        {
+            if (binCounts[bin] > 0)
+            {
+                leftBox = leftCount == 0 ? binBoxes[bin] : combine(leftBox, binBoxes[bin]);
+                leftCount += binCounts[bin];
+            }
+            if (leftCount == 0 || leftCount == count) { continue; }
+
+            const float cost = area(leftBox) * static_cast<float>(leftCount) + rightCosts[bin];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = bin;
+            }
+        }
+    }
+
+    size_t middle = 0;
+    if (bestAxis != -1)
+    {
+        const float scale = binCount / (centres.max[bestAxis] - centres.min[bestAxis]);
+        buildItem *split = std::partition(items, items + count, [&](const buildItem &item) {
+            return binOf(item, bestAxis, scale) <= bestSplit;
+        });
+        middle = static_cast<size_t>(split - items);
+    }
+
+    // Every centre is in the same place, so the items are split in half instead.
+    if (middle == 0 || middle == count)
+    {
+        middle = count / 2;
+        std::nth_element(items, items + middle, items + count, [](const buildItem &lhs, const buildItem &rhs) {
+            return lhs.centre.x < rhs.centre.x;
+        });
+    }
+
+    const int index = allocateNode();
+    mNodes[index].parent = parent;
+    const int child1 = buildRange(items, middle, index);
+    const int child2 = buildRange(items + middle, count - middle, index);
+
+    node &current = mNodes[index];
+    current.child1 = child1;
+    current.child2 = child2;
+    current.box = combine(mNodes[child1].box, mNodes[child2].box);
+    current.height = 1 + std::max(mNodes[child1].height, mNodes[child2].height);
+    return index;
+}
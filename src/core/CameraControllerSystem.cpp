@@ -49,11 +49,8 @@ void CameraControllerSystem::moveFirstPerson(float tickRate)
     glfwSetCursorPos(mWindow, 0.0, 0.0);
 
     // This should only really update the main camera as you don't want to move all the camera's at once.
-    for (const auto &entity : mEntities)
+    for (auto [cameraController, transform] : view<CameraController, Transform>())
     {
-        auto &cameraController = getComponent<CameraController>(entity);
-        auto &transform = getComponent<Transform>(entity);
-
         cameraController.horizontalAngle += cameraController.mouseSpeed * tickRate * -xPos;
         cameraController.verticalAngle += cameraController.mouseSpeed * tickRate * yPos;
 
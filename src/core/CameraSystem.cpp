@@ -7,6 +7,7 @@
  */
 
 #include "CameraSystem.h"
+#include "MatrixMath.h"
 
 #include <glfw3.h>
 
@@ -15,10 +16,8 @@ void CameraSystem::init()
     GLFWwindow *window = glfwGetCurrentContext();
     glm::ivec2 viewPortSize;
     glfwGetWindowSize(window, &viewPortSize.x, &viewPortSize.y);
-    for (const auto &entity : mEntities)
+    for (auto [camera, mat] : view<const Camera, CameraMatrices>())
     {
-        const auto &camera = getComponent<Camera>(entity);
-        auto &mat = getComponent<CameraMatrices>(entity);
         mat.projectionMatrix = glm::perspective(
                 camera.fovY,
                 static_cast<float>(viewPortSize.x) / static_cast<float>(viewPortSize.y),
@@ -27,27 +26,46 @@ void CameraSystem::init()
     }
 }
 
-void CameraSystem::update()
+void CameraSystem::update(float /*deltaTime*/)
 {
-    for (const auto &entity : mEntities)
-    {
-        const auto &camera = getComponent<Camera>(entity);
-        const auto transform = getComponent<Transform>(entity);
+    // Cameras that haven't moved or had their settings changed keep last frame's matrices. There are only ever a
+    // few cameras so each one is checked rather than filtering the view, as a parent may have moved instead.
+    const bool parentsChanged = hasAnyChanged<Parent>();
+    view<const Camera, const Transform>().each(
+            [this, parentsChanged](ecs::entity entity, const Camera &camera, const Transform &transform) {
+        const ecs::entity parent = hasComponent<Parent>(entity) ? getComponent<const Parent>(entity).entity : ecs::invalidId;
+        const bool hasParent = parent != ecs::invalidId && hasComponent<WorldTransform>(parent);
+        const bool moved = parentsChanged || hasChanged<Transform>(entity)
+                || (hasParent && hasChanged<WorldTransform>(parent));
+        if (!moved && !hasChanged<Camera>(entity)) { return; }
+
         auto &mat = getComponent<CameraMatrices>(entity);
+        if (moved)
+        {
+            const glm::mat4 translation = glm::translate(glm::mat4(1.f), transform.position);
+            const glm::mat4 rotation = glm::toMat4(transform.rotation);
+            const glm::mat4 scale = glm::scale(glm::mat4(1.f), transform.scale);
 
-        const glm::mat4 translation = glm::translate(glm::mat4(1.f), transform.position);
-        const glm::mat4 rotation = glm::toMat4(transform.rotation);
-        const glm::mat4 scale = glm::scale(glm::mat4(1.f), transform.scale);
+            // View Matrices are from world space to Camera space. (Therefore the opposite of a model Matrix)
+            mat.viewMatrix = scale * rotation * translation;
 
-        // View Matrices are from world space to Camera space. (Therefore the opposite of a model Matrix)
-        mat.viewMatrix = scale * rotation * translation;
+            // Undo the parent's world matrix first so that the camera follows it around.
+            if (hasParent)
+            {
+                const auto &parentWorld = getComponent<const WorldTransform>(parent);
+                mat.viewMatrix = math::multiply(mat.viewMatrix, glm::inverse(parentWorld.matrix));
+            }
+        }
 
-        mat.projectionMatrix = glm::perspective(
-                camera.fovY,
-                1920.f / 1080.f,
-                camera.zNear,
-                camera.zFar);
+        if (hasChanged<Camera>(entity))
+        {
+            mat.projectionMatrix = glm::perspective(
+                    camera.fovY,
+                    1920.f / 1080.f,
+                    camera.zNear,
+                    camera.zFar);
+        }
 
         mat.vpMatrix = mat.projectionMatrix * mat.viewMatrix;
-    }
+    });
 }
@@ -9,6 +9,7 @@
 #include "Core.h"
 #include "Scene.h"
 #include "DebugLogger.h"
+#include "OpenGlLogger.h"
 
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
@@ -39,7 +40,7 @@ bool Core::initGlfw()
     if (!glfwInit()) { return false; }
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);  // Version of opengl you want to use
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);  // 4.5 rather than 4.6 so that Mesa's software renderer works.
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);  // For debugging
 
@@ -70,9 +71,13 @@ bool Core::initOpenGl()
     glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
     if (!(flags & GL_CONTEXT_FLAG_DEBUG_BIT)) { return false; }
 
-    // Blending texture data / enabling lerping.
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // The renderer reads per instance data with gl_BaseInstanceARB.
+    if (!GLEW_ARB_shader_draw_parameters)
+    {
+        debug::log("GL_ARB_shader_draw_parameters is not supported by this driver.", debug::severity::Fatal);
+    }
+
+    // Blending is only turned on by the renderer for its transparent pass.
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
 
@@ -114,9 +119,11 @@ void Core::update()
 
 void Core::render()
 {
+    glm::ivec2 resolution;
+    glfwGetFramebufferSize(mWindow, &resolution.x, &resolution.y);
     for (auto &scene : mScenes)
     {
-        scene->render();
+        scene->render(resolution);
     }
 }
 
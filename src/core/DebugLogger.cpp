@@ -9,7 +9,10 @@
 #include "DebugLogger.h"
 
 #include <fstream>
+#include <iostream>
 #include <sstream>
+#include <string>
+#include <unordered_map>
 
 namespace debug
 {
@@ -26,34 +29,6 @@ namespace debug
 
     static std::string_view fileName = "log.txt";
 
-    static std::unordered_map<GLenum, std::string_view> glSourceMap {
-            { GL_DEBUG_SOURCE_API,              "API" },
-            { GL_DEBUG_SOURCE_WINDOW_SYSTEM ,   "Window System" },
-            { GL_DEBUG_SOURCE_SHADER_COMPILER,  "Shader Compiler" },
-            { GL_DEBUG_SOURCE_THIRD_PARTY,      "Third Party" },
-            { GL_DEBUG_SOURCE_APPLICATION,      "Application" },
-            { GL_DEBUG_SOURCE_OTHER,            "Other" },
-    };
-
-    static std::unordered_map<GLenum, std::string_view> glTypeMap {
-            { GL_DEBUG_TYPE_ERROR,                  "Error" },
-            { GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR,    "Deprecated Behavior" },
-            { GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR,     "Undefined Behavior" },
-            { GL_DEBUG_TYPE_PORTABILITY,            "Portability" },
-            { GL_DEBUG_TYPE_MARKER,                 "Marker" },
-            { GL_DEBUG_TYPE_PUSH_GROUP,             "Push Group" },
-            { GL_DEBUG_TYPE_POP_GROUP,              "Pop Group" },
-            { GL_DEBUG_TYPE_OTHER,                  "Other" },
-    };
-
-    // GL notification is not aligned with the others.
-    static std::unordered_map<GLenum, severity> glSeverityCastMap {
-            { GL_DEBUG_SEVERITY_NOTIFICATION,   severity::Notification },
-            { GL_DEBUG_SEVERITY_LOW,            severity::Minor },
-            { GL_DEBUG_SEVERITY_MEDIUM,         severity::Major },
-            { GL_DEBUG_SEVERITY_HIGH,           severity::Fatal },
-    };
-
 
     // Throw level getters and setters.
     void setThrowLevel(severity level) { throwLevel = level; }
@@ -83,19 +58,19 @@ namespace debug
         logConsole(output);
     }
 
-    void log(std::string_view message, severity level)
+    void logFormatted(std::string_view output, severity level)
     {
-        std::stringstream ss;
-        ss << "-- Log Call --\n";
-        ss << "Severity: " << severityStringMap.at(level) << "\n";
-        ss << " Message: " << message << "\n";
-        ss << "-- End Log Call --\n";
-
-        logToSources(ss);
+        logFile(output);
+        logConsole(output);
         if (level >= throwLevel) { throw LogException(); }
     }
 
-    void log(const unsigned char *message, severity level)
+    std::string_view toString(severity level)
+    {
+        return severityStringMap.at(level);
+    }
+
+    void log(std::string_view message, severity level)
     {
         std::stringstream ss;
         ss << "-- Log Call --\n";
@@ -107,19 +82,13 @@ namespace debug
         if (level >= throwLevel) { throw LogException(); }
     }
 
-    void openglCallBack(GLenum source, GLenum type, GLuint id,
-                        GLenum severity, GLsizei length,
-                        const GLchar *message, const void *userParam)
+    void log(const unsigned char *message, severity level)
     {
-        debug::severity level = glSeverityCastMap.at(severity);
-
         std::stringstream ss;
-        ss << "-- OpenGL Log ( "<< id <<" ) --\n";
-
-        ss << "  Source: " <<  glSourceMap.at(source) << "\n";
-        ss << "    Type: " << glTypeMap.at(type) << "\n";
+        ss << "-- Log Call --\n";
         ss << "Severity: " << severityStringMap.at(level) << "\n";
         ss << " Message: " << message << "\n";
+        ss << "-- End Log Call --\n";
 
         logToSources(ss);
         if (level >= throwLevel) { throw LogException(); }
@@ -0,0 +1,59 @@
+/**
+ * @file Hierarchy.cpp
+ * @brief Attaches entities to each other so that they move together.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "Hierarchy.h"
+#include "Components.h"
+
+#include <algorithm>
+
+namespace hierarchy
+{
+    /** @return True if entity is ancestor or sits somewhere below it. */
+    bool isDescendantOf(EcsDirector &director, ecs::entity entity, ecs::entity ancestor)
+    {
+        while (entity != ancestor)
+        {
+            if (!director.isAlive(entity) || !director.hasComponent<Parent>(entity)) { return false; }
+            entity = director.getComponent<const Parent>(entity).entity;
+        }
+        return true;
+    }
+
+    void setParent(EcsDirector &director, ecs::entity child, ecs::entity parent)
+    {
+        if (isDescendantOf(director, parent, child))
+        {
+            debug::log("An entity can't be parented to itself or one of its children.", debug::severity::Warning);
+            return;
+        }
+
+        removeParent(director, child);
+        director.addComponent(child, Parent { parent });
+        if (director.hasComponent<Children>(parent))
+        {
+            director.getComponent<Children>(parent).entities.push_back(child);
+        }
+        else
+        {
+            director.addComponent(parent, Children { { child } });
+        }
+    }
+
+    void removeParent(EcsDirector &director, ecs::entity child)
+    {
+        if (!director.hasComponent<Parent>(child)) { return; }
+
+        const ecs::entity parent = director.getComponent<const Parent>(child).entity;
+        if (director.isAlive(parent) && director.hasComponent<Children>(parent))
+        {
+            auto &siblings = director.getComponent<Children>(parent).entities;
+            siblings.erase(std::remove(siblings.begin(), siblings.end(), child), siblings.end());
+        }
+        director.removeComponent<Parent>(child);
+    }
+}
@@ -0,0 +1,62 @@
+/**
+ * @file OpenGlLogger.cpp
+ * @brief Forwards OpenGL debug messages to the debug logger.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "OpenGlLogger.h"
+#include "DebugLogger.h"
+
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+namespace debug
+{
+    static std::unordered_map<GLenum, std::string_view> glSourceMap {
+            { GL_DEBUG_SOURCE_API,              "API" },
+            { GL_DEBUG_SOURCE_WINDOW_SYSTEM ,   "Window System" },
+            { GL_DEBUG_SOURCE_SHADER_COMPILER,  "Shader Compiler" },
+            { GL_DEBUG_SOURCE_THIRD_PARTY,      "Third Party" },
+            { GL_DEBUG_SOURCE_APPLICATION,      "Application" },
+            { GL_DEBUG_SOURCE_OTHER,            "Other" },
+    };
+
+    static std::unordered_map<GLenum, std::string_view> glTypeMap {
+            { GL_DEBUG_TYPE_ERROR,                  "Error" },
+            { GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR,    "Deprecated Behavior" },
+            { GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR,     "Undefined Behavior" },
+            { GL_DEBUG_TYPE_PORTABILITY,            "Portability" },
+            { GL_DEBUG_TYPE_MARKER,                 "Marker" },
+            { GL_DEBUG_TYPE_PUSH_GROUP,             "Push Group" },
+            { GL_DEBUG_TYPE_POP_GROUP,              "Pop Group" },
+            { GL_DEBUG_TYPE_OTHER,                  "Other" },
+    };
+
+    // GL notification is not aligned with the others.
+    static std::unordered_map<GLenum, severity> glSeverityCastMap {
+            { GL_DEBUG_SEVERITY_NOTIFICATION,   severity::Notification },
+            { GL_DEBUG_SEVERITY_LOW,            severity::Minor },
+            { GL_DEBUG_SEVERITY_MEDIUM,         severity::Major },
+            { GL_DEBUG_SEVERITY_HIGH,           severity::Fatal },
+    };
+
+    void openglCallBack(GLenum source, GLenum type, GLuint id,
+                        GLenum severity, GLsizei length,
+                        const GLchar *message, const void *userParam)
+    {
+        debug::severity level = glSeverityCastMap.at(severity);
+
+        std::stringstream ss;
+        ss << "-- OpenGL Log ( "<< id <<" ) --\n";
+
+        ss << "  Source: " <<  glSourceMap.at(source) << "\n";
+        ss << "    Type: " << glTypeMap.at(type) << "\n";
+        ss << "Severity: " << toString(level) << "\n";
+        ss << " Message: " << message << "\n";
+
+        logFormatted(ss.str(), level);
+    }
+}
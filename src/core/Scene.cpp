@@ -9,18 +9,25 @@
 #include "Scene.h"
 #include "Components.h"
 #include "Primitives.h"
-#include "Loader.h"
 #include "MaterialProcessor.h"
 
+namespace
+{
+    // The sources that primitive meshes are added with, so that snapshots can rebuild them.
+    constexpr std::string_view cubeSource { "primitives::cube" };
+    constexpr std::string_view inverseCubeSource { "primitives::inverseCube" };
+}
 
 Scene::Scene()
 {
     // Must be in this order.
     registerComponents();
+    registerSerializers();
     registerSystems();
     registerEntities();
 
     mRendererSystem->setMainCamera(mMainCamera);
+    mRendererSystem->init();
     mRendererSystem->mMaterialProcessor->init();
     mCameraSystem->init();
 }
@@ -28,7 +35,12 @@ Scene::Scene()
 void Scene::registerComponents()
 {
     mDirector.registerComponent<Transform>();
-    mDirector.registerComponent<PolygonalMesh>();
+    mDirector.registerComponent<WorldTransform>();
+    mDirector.registerComponent<Parent>();
+    mDirector.registerComponent<Children>();
+    mDirector.registerComponent<MeshHandle>();
+    mDirector.registerComponent<Bounds>();
+    mDirector.registerComponent<Occluder>();
     mDirector.registerComponent<Camera>();
     mDirector.registerComponent<CameraMatrices>();
     mDirector.registerComponent<CameraController>();
@@ -40,65 +52,141 @@ void Scene::registerComponents()
     mDirector.registerComponent<PointLight>();
 }
 
+void Scene::registerSerializers()
+{
+    // Everything else is trivially copyable and is written to snapshots as it is.
+    mDirector.registerSerializer<MeshHandle>(
+        [this](SnapshotWriter &writer, const MeshHandle &mesh) { writeMesh(writer, mesh); },
+        [this](SnapshotReader &reader, MeshHandle &mesh) { mesh = readMesh(reader); });
+
+    mDirector.registerSerializer<Occluder>(
+        [this](SnapshotWriter &writer, const Occluder &occluder) { writeMesh(writer, occluder.mesh); },
+        [this](SnapshotReader &reader, Occluder &occluder) { occluder.mesh = readMesh(reader); });
+
+    mDirector.registerSerializer<Children>(
+        [](SnapshotWriter &writer, const Children &children) { writer.write(children.entities); },
+        [](SnapshotReader &reader, Children &children) { reader.read(children.entities); });
+
+    mDirector.registerSerializer<RendererUniforms>(
+        [](SnapshotWriter &writer, const RendererUniforms &uniforms) {
+            writer.write(uniforms.materialIds);
+            writer.write(uniforms.diffuseTexturesId);
+            writer.write(uniforms.normalMapId);
+        },
+        [](SnapshotReader &reader, RendererUniforms &uniforms) {
+            reader.read(uniforms.materialIds);
+            reader.read(uniforms.diffuseTexturesId);
+            reader.read(uniforms.normalMapId);
+        });
+
+    mDirector.registerSerializer<Textures>(
+        [](SnapshotWriter &writer, const Textures &textures) {
+            writer.write(textures.filePaths);
+            writer.write(textures.widths);
+            writer.write(textures.heights);
+        },
+        [](SnapshotReader &reader, Textures &textures) {
+            reader.read(textures.filePaths);
+            reader.read(textures.widths);
+            reader.read(textures.heights);
+        });
+
+    mDirector.registerSerializer<TextureIds>(
+        [](SnapshotWriter &writer, const TextureIds &ids) { writer.write(ids); },
+        [](SnapshotReader &reader, TextureIds &ids) { reader.read(ids); });
+
+    mDirector.registerSerializer<std::vector<Material>>(
+        [](SnapshotWriter &writer, const std::vector<Material> &materials) { writer.write(materials); },
+        [](SnapshotReader &reader, std::vector<Material> &materials) { reader.read(materials); });
+
+    mDirector.registerSerializer<std::vector<MaterialTexture>>(
+        [](SnapshotWriter &writer, const std::vector<MaterialTexture> &textures) {
+            writer.write(static_cast<uint64_t>(textures.size()));
+            for (const auto &texture : textures)
+            {
+                writer.write(texture.kDPath);
+                writer.write(texture.normalMapPath);
+            }
+        },
+        [](SnapshotReader &reader, std::vector<MaterialTexture> &textures) {
+            textures.resize(reader.readSize());
+            for (auto &texture : textures)
+            {
+                reader.read(texture.kDPath);
+                reader.read(texture.normalMapPath);
+            }
+        });
+}
+
 void Scene::registerSystems()
 {
-    ecs::signature rendererSignature;
-    rendererSignature.set(mDirector.getComponentId<Transform>());
-    rendererSignature.set(mDirector.getComponentId<PolygonalMesh>());
-    rendererSignature.set(mDirector.getComponentId<RendererUniforms>());
+    mTransformSystem = mDirector.registerSystem<TransformSystem>();
+    mDirector.setSystemSignature<TransformSystem, Transform, WorldTransform>();
+
+    mSpatialSystem = mDirector.registerSystem<SpatialSystem>();
+    mDirector.setSystemSignature<SpatialSystem, WorldTransform, Bounds>();
+
     mRendererSystem = mDirector.registerSystem<RendererSystem>();
-    mDirector.setSystemSignature<RendererSystem>(rendererSignature);
+    mDirector.setSystemSignature<RendererSystem, WorldTransform, MeshHandle, Bounds, RendererUniforms>();
 
-    ecs::signature materialSignature;
-    materialSignature.set(mDirector.getComponentId<RendererUniforms>());
-    materialSignature.set(mDirector.getComponentId<std::vector<Material>>());
-    materialSignature.set(mDirector.getComponentId<std::vector<MaterialTexture>>());
     mRendererSystem->mMaterialProcessor = mDirector.registerSystem<MaterialProcessor>();
-    mDirector.setSystemSignature<MaterialProcessor>(materialSignature);
+    mDirector.setSystemSignature<MaterialProcessor,
+        RendererUniforms, std::vector<Material>, std::vector<MaterialTexture>>();
+
+    mRendererSystem->mSpatialSystem = mSpatialSystem;
+
+    mRendererSystem->mOccluderSystem = mDirector.registerSystem<OccluderSystem>();
+    mDirector.setSystemSignature<OccluderSystem, Occluder, WorldTransform>();
 
-    ecs::signature lightingSignature;
-    lightingSignature.set(mDirector.getComponentId<PointLight>());
-    lightingSignature.set(mDirector.getComponentId<Transform>());
     mRendererSystem->mPointLightTransformer = mDirector.registerSystem<PointLightTransformer>();
-    mDirector.setSystemSignature<PointLightTransformer>(lightingSignature);
+    mDirector.setSystemSignature<PointLightTransformer, PointLight, WorldTransform>();
 
-    ecs::signature cameraSystemSignature;
-    cameraSystemSignature.set(mDirector.getComponentId<Transform>());
-    cameraSystemSignature.set(mDirector.getComponentId<Camera>());
-    cameraSystemSignature.set(mDirector.getComponentId<CameraMatrices>());
     mCameraSystem = mDirector.registerSystem<CameraSystem>();
-    mDirector.setSystemSignature<CameraSystem>(cameraSystemSignature);
+    mDirector.setSystemSignature<CameraSystem, Transform, Camera, CameraMatrices>();
 
-    ecs::signature camControllerSignature;
-    camControllerSignature.set(mDirector.getComponentId<CameraController>());
-    camControllerSignature.set(mDirector.getComponentId<Transform>());
-    camControllerSignature.set(mDirector.getComponentId<CameraMatrices>());
     mCameraControllerSystem = mDirector.registerSystem<CameraControllerSystem>();
-    mDirector.setSystemSignature<CameraControllerSystem>(camControllerSignature);
+    mDirector.setSystemSignature<CameraControllerSystem, CameraController, Transform, CameraMatrices>();
+
+    // Update order for systems that conflict is the order that they are scheduled in.
+    mDirector.scheduleSystem<TransformSystem>(ecs::read<Transform, Parent>(), ecs::write<WorldTransform>());
+    mDirector.scheduleSystem<SpatialSystem>(ecs::read<WorldTransform, Bounds>(), ecs::write<>());
+    mDirector.scheduleSystem<CameraSystem>(
+            ecs::read<Camera, Transform, Parent, WorldTransform>(), ecs::write<CameraMatrices>());
+    mDirector.scheduleSystem<CameraControllerSystem>(
+            ecs::read<>(), ecs::write<CameraController, Transform>(), ecs::thread::Main);  // Polls glfw input.
 }
 
 void Scene::registerEntities()
 {
+    MeshRegistry &meshRegistry = mRendererSystem->mMeshRegistry;
+
     auto cube = mDirector.createEntity();
-    mDirector.addComponent(cube, Transform());
-    mDirector.addComponent(cube, primitives::cube());
-    mDirector.addComponent(cube, RendererUniforms());
+    const MeshHandle cubeMesh = meshRegistry.add(primitives::cube(), cubeSource);
+    mDirector.addComponents(cube,
+        Transform(),
+        WorldTransform(),
+        cubeMesh,
+        meshRegistry.getBounds(cubeMesh),
+        RendererUniforms());
 
     auto teapot = mDirector.createEntity();
-    mDirector.addComponent(teapot, Transform{ glm::vec3(0.f, -1.f, 0.f) });
-    mDirector.addComponent(teapot, loadModel(R"(E:\Blender\Scenes\LoadingTest\LoadingDemo.obj)"));
+    mDirector.addComponents(teapot, Transform{ glm::vec3(0.f, -1.f, 0.f) }, WorldTransform());
+    addModel(teapot, R"(E:\Blender\Scenes\LoadingTest\LoadingDemo.obj)");
+    mDirector.addComponent(teapot, Occluder());
 //
     auto tank = mDirector.createEntity();
-    mDirector.addComponent(tank, Transform{ glm::vec3(0.f, 0.f, 15.f) });
-    mDirector.addComponent(tank, loadModel("../res/models/CubesTextures.obj"));
+    mDirector.addComponents(tank, Transform{ glm::vec3(0.f, 0.f, 15.f) }, WorldTransform());
+    addModel(tank, "../res/models/CubesTextures.obj");
 
     auto kirb = mDirector.createEntity();
-    mDirector.addComponent(kirb, Transform{
+    mDirector.addComponents(kirb,
+        Transform{
             glm::vec3(0.f, 0.f, -15.f),
             glm::quat(),
             glm::vec3(1.f)
-    });
-    mDirector.addComponent(kirb, loadModel("../res/models/SphereTextures.obj"));
+        },
+        WorldTransform());
+    addModel(kirb, "../res/models/SphereTextures.obj");
 
 //    auto light = mDirector.createEntity();
 //    mDirector.addComponent(light, PointLight { glm::vec3(1.f) });
@@ -111,48 +199,133 @@ void Scene::registerEntities()
 //    mDirector.addComponent(light, RendererUniforms());
 
     mLight = mDirector.createEntity();
-    mDirector.addComponent(mLight, PointLight { glm::vec3(1.f), 1.f, 150.f });
-    mDirector.addComponent(mLight, Transform {
-        glm::vec3(0.f, 15.f, 0.f),
-        glm::quat(),
-        glm::vec3(0.1f)
-    } );
-    mDirector.addComponent(mLight, primitives::inverseCube());
-    mDirector.addComponent(mLight, RendererUniforms());
+    const MeshHandle lightMesh = meshRegistry.add(primitives::inverseCube(), inverseCubeSource);
+    mDirector.addComponents(mLight,
+        PointLight { glm::vec3(1.f), 1.f, 150.f },
+        Transform {
+            glm::vec3(0.f, 15.f, 0.f),
+            glm::quat(),
+            glm::vec3(0.1f)
+        },
+        WorldTransform(),
+        lightMesh,
+        meshRegistry.getBounds(lightMesh),
+        RendererUniforms());
 
 
     mMainCamera = mDirector.createEntity();
-    mDirector.addComponent(mMainCamera, Transform{
+    mDirector.addComponents(mMainCamera,
+        Transform{
             glm::vec3(0.f, -0.7f, -0.8f),
             glm::quat(glm::vec3(0.f, 0.f, 0.f)),
             glm::vec3(1.f)
-    });
-    mDirector.addComponent(mMainCamera, CameraMatrices());
-    mDirector.addComponent(mMainCamera, Camera());
-    mDirector.addComponent(mMainCamera, CameraController());
+        },
+        CameraMatrices(),
+        Camera(),
+        CameraController());
+}
+
+void Scene::addModel(ecs::entity entity, std::string_view path)
+{
+    MeshRegistry &meshRegistry = mRendererSystem->mMeshRegistry;
+    const auto &[mesh, materials, matTextures] = meshRegistry.load(path);
+    if (!mesh.isValid()) { return; }  // Object failed to load.
+    mDirector.addComponents(entity, mesh, meshRegistry.getBounds(mesh), RendererUniforms(), materials, matTextures);
 }
 
 void Scene::update(float deltaTime)
 {
-    mCameraSystem->update();
-    mCameraControllerSystem->update(deltaTime);
+    mDirector.update(deltaTime);
 }
 
-void Scene::render()
+void Scene::render(const glm::ivec2 &resolution)
 {
-    mRendererSystem->render();
+    mRendererSystem->render(resolution);
 }
 
 void Scene::renderImGui()
 {
-    auto &lightPos = mDirector.getComponent<Transform>(mLight);
-    auto &lightValues = mDirector.getComponent<PointLight>(mLight);
-    ImGui::SliderFloat3("Pos", &lightPos.position[0], -30.f, 30.f);
-    ImGui::SliderFloat3("Colour", &lightValues.kDiffuse[0], 0.f, 1.f);
-    ImGui::SliderFloat("Intensity", &lightValues.intensity, 0.f, 1.f);
-    ImGui::SliderFloat("Fall Off", &lightValues.fallOff, 0.f, 1000.f);
+    // Edited through copies so that the light only counts as changed on the frames that a slider moves.
+    glm::vec3 lightPosition = mDirector.getComponent<const Transform>(mLight).position;
+    PointLight lightValues = mDirector.getComponent<const PointLight>(mLight);
+    if (ImGui::SliderFloat3("Pos", &lightPosition[0], -30.f, 30.f))
+    {
+        mDirector.getComponent<Transform>(mLight).position = lightPosition;
+    }
+
+    bool isLightChanged = ImGui::SliderFloat3("Colour", &lightValues.kDiffuse[0], 0.f, 1.f);
+    isLightChanged |= ImGui::SliderFloat("Intensity", &lightValues.intensity, 0.f, 1.f);
+    isLightChanged |= ImGui::SliderFloat("Fall Off", &lightValues.fallOff, 0.f, 1000.f);
+    if (isLightChanged) { mDirector.getComponent<PointLight>(mLight) = lightValues; }
+    if (ImGui::CollapsingHeader("Renderer"))
+    {
+        MeshArena &arena = mRendererSystem->mMeshRegistry.getArena();
+        ImGui::Text("Mesh upload: %zu bytes", mRendererSystem->getMeshUploadBytes());
+        ImGui::Text("Draws: %zu (%zu instances, %zu transparent)", mRendererSystem->getDrawCount(),
+                    mRendererSystem->getInstanceCount(), mRendererSystem->getTransparentCount());
+        ImGui::Text("Culled: %zu of %zu (%zu more occluded)", mRendererSystem->getCulledCount(),
+                    mRendererSystem->getTestedCount(), mRendererSystem->getOccludedCount());
+        const AabbTree &staticTree = mSpatialSystem->getStaticTree();
+        const AabbTree &dynamicTree = mSpatialSystem->getDynamicTree();
+        ImGui::Text("Static tree: %zu (height %d)", staticTree.size(), staticTree.getHeight());
+        ImGui::Text("Dynamic tree: %zu (height %d)", dynamicTree.size(), dynamicTree.getHeight());
+        const MaterialPool &materials = mRendererSystem->mMaterialProcessor->getMaterialPool();
+        ImGui::Text("Materials: %zu (%zu bytes uploaded)", materials.size(), materials.getLastUploadBytes());
+        ImGui::Text("Mesh arena fragmentation: %.2f", arena.fragmentation());
+        if (ImGui::Button("Defragment Mesh Arena")) { arena.defragment(); }
+    }
+    if (ImGui::CollapsingHeader("Render Passes"))
+    {
+        const FrameGraph &frameGraph = mRendererSystem->getFrameGraph();
+        for (const auto &[name, milliseconds, culled] : frameGraph.getTimings())
+        {
+            if (culled) { ImGui::Text("%.*s: culled", static_cast<int>(name.size()), name.data()); }
+            else { ImGui::Text("%.*s: %.3fms", static_cast<int>(name.size()), name.data(), milliseconds); }
+        }
+        ImGui::Text("Transient textures: %zu in %zu pooled", frameGraph.getTransientTextureCount(),
+                    frameGraph.getPooledTextureCount());
+    }
+    if (ImGui::CollapsingHeader("Systems"))
+    {
+        for (const auto &[name, stage, milliseconds] : mDirector.getScheduler().getTimings())
+        {
+            ImGui::Text("[%zu] %.*s: %.3fms", stage, static_cast<int>(name.size()), name.data(), milliseconds);
+        }
+    }
+
     static bool wireFrame;
     ImGui::Checkbox("Wireframe", &wireFrame);
     if (wireFrame) { glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); }
     else { glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); }
 }
+
+void Scene::writeMesh(SnapshotWriter &writer, MeshHandle mesh) const
+{
+    // An invalid handle is written as an empty source and read back as an invalid handle.
+    if (!mesh.isValid())
+    {
+        writer.write(std::string());
+        return;
+    }
+
+    const std::string &source = mRendererSystem->mMeshRegistry.getSource(mesh);
+    if (source.empty())
+    {
+        debug::log("Mesh " + std::to_string(mesh.id) + " has no source, so it can't be found again from a snapshot.",
+                   debug::severity::Warning);
+    }
+    writer.write(source);
+}
+
+MeshHandle Scene::readMesh(SnapshotReader &reader)
+{
+    std::string source;
+    reader.read(source);
+    if (source.empty()) { return {}; }
+
+    MeshRegistry &meshRegistry = mRendererSystem->mMeshRegistry;
+    if (const MeshHandle mesh = meshRegistry.find(source); mesh.isValid()) { return mesh; }
+    if (source == cubeSource) { return meshRegistry.add(primitives::cube(), cubeSource); }
+    if (source == inverseCubeSource) { return meshRegistry.add(primitives::inverseCube(), inverseCubeSource); }
+    return meshRegistry.load(source).mesh;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file SpatialSystem.cpp
+ * @brief Keeps every entity with Bounds in a pair of AABB trees.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "SpatialSystem.h"
+
+#include <algorithm>
+
+void SpatialSystem::update(float /*deltaTime*/)
+{
+    ++mUpdate;
+    if (mEntitiesVersion != mEntities.version()) { reconcileEntities(); }
+
+    view<const WorldTransform, const Bounds>().changed<WorldTransform, Bounds>().each(
+            [this](ecs::entity entity, const WorldTransform &world, const Bounds &bounds) {
+        record &entry = getRecord(entity);
+        const AabbTree::aabb box = toWorld(bounds, world.matrix);
+        if (entry.tree == treeKind::None)
+        {
+            insertStatic(entry, box);
+            return;
+        }
+        if (entry.lastMoved == mUpdate) { return; }  // Inserted by reconcileEntities() this update.
+
+        entry.lastMoved = mUpdate;
+        if (entry.tree == treeKind::Static)
+        {
+            mStaticTree.remove(entry.proxy);
+            entry.proxy = mDynamicTree.insert(box, entity);
+            entry.tree = treeKind::Dynamic;
+            mDynamicEntities.push_back(entity);
+        }
+        else
+        {
+            mDynamicTree.move(entry.proxy, box);
+        }
+    });
+
+    settleDynamic();
+
+    // Inserting keeps the static tree usable. A full rebuild is only worth it once a lot has been added.
+    if (mStaticHasUnlinked || mStaticInsertsSinceRebuild > getRebuildThreshold())
+    {
+        mStaticTree.rebuild();
+        mStaticInsertsSinceRebuild = 0;
+        mStaticHasUnlinked = false;
+    }
+}
+
+AabbTree::aabb SpatialSystem::toWorld(const Bounds &bounds, const glm::mat4 &world)
+{
+    // The box's extent along each world axis is the sum of the absolute rotated local extents.
+    const glm::vec3 centre = glm::vec3(world * glm::vec4((bounds.min + bounds.max) * 0.5f, 1.f));
+    const glm::vec3 halfSize = (bounds.max - bounds.min) * 0.5f;
+    const glm::vec3 extent = glm::abs(glm::vec3(world[0])) * halfSize.x
+                             + glm::abs(glm::vec3(world[1])) * halfSize.y
+                             + glm::abs(glm::vec3(world[2])) * halfSize.z;
+    return { centre - extent, centre + extent };
+}
+
+SpatialSystem::record &SpatialSystem::getRecord(ecs::entity entity)
+{
+    const ecs::entityIndex index = ecs::indexOf(entity);
+    if (index >= mRecords.size()) { mRecords.resize(index + 1); }
+
+    record &entry = mRecords[index];
+    if (entry.entity != entity)
+    {
+        // The index has been reused by a new entity, so the old one has to leave the trees first.
+        if (entry.tree != treeKind::None) { untrack(entry); }
+        entry.entity = entity;
+    }
+    return entry;
+}
+
+void SpatialSystem::insertStatic(record &entry, const AabbTree::aabb &box, bool linked)
+{
+    entry.proxy = linked ? mStaticTree.insert(box, entry.entity) : mStaticTree.insertUnlinked(box, entry.entity);
+    mStaticHasUnlinked |= !linked;
+    entry.tree = treeKind::Static;
+    entry.lastMoved = mUpdate;
+    ++mStaticInsertsSinceRebuild;
+}
+
+void SpatialSystem::untrack(record &entry)
+{
+    if (entry.tree == treeKind::Static) { mStaticTree.remove(entry.proxy); }
+    else if (entry.tree == treeKind::Dynamic) { mDynamicTree.remove(entry.proxy); }
+    entry.proxy = AabbTree::nullNode;
+    entry.tree = treeKind::None;
+}
+
+void SpatialSystem::reconcileEntities()
+{
+    mEntitiesVersion = mEntities.version();
+    for (record &entry : mRecords)
+    {
+        if (entry.tree != treeKind::None && !mEntities.contains(entry.entity)) { untrack(entry); }
+    }
+
+    size_t joined = 0;
+    for (const ecs::entity entity : mEntities)
+    {
+        if (getRecord(entity).tree == treeKind::None) { ++joined; }
+    }
+
+    // Loading a scene adds everything at once. Placing each box would be wasted on a tree that is rebuilt anyway.
+    const bool linked = joined <= getRebuildThreshold();
+    for (const ecs::entity entity : mEntities)
+    {
+        record &entry = getRecord(entity);
+        if (entry.tree != treeKind::None) { continue; }
+
+        const auto &world = getComponent<const WorldTransform>(entity);
+        insertStatic(entry, toWorld(getComponent<const Bounds>(entity), world.matrix), linked);
+    }
+}
+
+void SpatialSystem::settleDynamic()
+{
+    for (size_t i = 0; i < mDynamicEntities.size();)
+    {
+        record &entry = mRecords[ecs::indexOf(mDynamicEntities[i])];
+        const bool isStale = entry.entity != mDynamicEntities[i] || entry.tree != treeKind::Dynamic;
+        const bool hasSettled = !isStale && mUpdate - entry.lastMoved >= settleUpdates;
+        if (!isStale && !hasSettled)
+        {
+            ++i;
+            continue;
+        }
+
+        if (hasSettled)
+        {
+            const auto &world = getComponent<const WorldTransform>(entry.entity);
+            mDynamicTree.remove(entry.proxy);
+            insertStatic(entry, toWorld(getComponent<const Bounds>(entry.entity), world.matrix));
+        }
+        mDynamicEntities[i] = mDynamicEntities.back();
+        mDynamicEntities.pop_back();
+    }
+}
@@ -0,0 +1,122 @@
+/**
+ * @file TransformSystem.cpp
+ * @brief Turns Transforms into WorldTransforms, following each entity's Parent.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "TransformSystem.h"
+#include "MatrixMath.h"
+
+#include <algorithm>
+
+void TransformSystem::update(float /*deltaTime*/)
+{
+    const bool orderIsStale = mEntitiesVersion != mEntities.version() || hasAnyChanged<Parent>();
+    if (orderIsStale)
+    {
+        rebuildOrder();
+    }
+    else if (!hasAnyChanged<Transform>())
+    {
+        return;  // Nothing has moved.
+    }
+
+    propagate(orderIsStale);
+}
+
+void TransformSystem::rebuildOrder()
+{
+    mEntitiesVersion = mEntities.version();
+    const size_t count = mEntities.size();
+    constexpr slot unknown = noParent;
+
+    // Parents by position in mEntities. Parents outside of this system, or that have been destroyed, make roots.
+    std::vector<slot> parents(count, noParent);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const ecs::entity entity = mEntities[i];
+        if (!hasComponent<Parent>(entity)) { continue; }
+
+        const size_t parentIndex = mEntities.find(getComponent<const Parent>(entity).entity);
+        if (parentIndex != EntitySet::invalidIndex) { parents[i] = static_cast<slot>(parentIndex); }
+    }
+
+    // Walks up from each entity until it reaches one with a known depth. Each entity is only walked once.
+    constexpr slot visiting = unknown - 1;
+    std::vector<slot> depths(count, unknown);
+    std::vector<slot> chain;
+    slot maxDepth = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        slot current = static_cast<slot>(i);
+        while (depths[current] == unknown)
+        {
+            if (parents[current] == noParent)
+            {
+                depths[current] = 0;
+                break;
+            }
+            depths[current] = visiting;
+            chain.push_back(current);
+            current = parents[current];
+        }
+
+        if (depths[current] == visiting)
+        {
+            debug::log("Parent cycle found. Treating the entity as a root.", debug::severity::Warning);
+            parents[current] = noParent;
+            depths[current] = 0;
+        }
+
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        {
+            if (parents[*it] == noParent) { continue; }  // The root that broke a cycle.
+            depths[*it] = depths[parents[*it]] + 1;
+            maxDepth = std::max(maxDepth, depths[*it]);
+        }
+        chain.clear();
+    }
+
+    // Counting sort by depth keeps siblings in the order that they are stored in.
+    std::vector<slot> starts(static_cast<size_t>(maxDepth) + 2, 0);
+    for (const slot depth : depths) { ++starts[depth + 1]; }
+    for (size_t d = 1; d < starts.size(); ++d) { starts[d] += starts[d - 1]; }
+
+    std::vector<slot> slots(count);
+    mOrder.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        slots[i] = starts[depths[i]]++;
+        mOrder[slots[i]] = mEntities[i];
+    }
+
+    mParents.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        mParents[slots[i]] = parents[i] == noParent ? noParent : slots[parents[i]];
+    }
+
+    mWorldMatrices.resize(count);
+    mDirty.resize(count);
+}
+
+void TransformSystem::propagate(bool all)
+{
+    for (size_t i = 0; i < mOrder.size(); ++i)
+    {
+        const ecs::entity entity = mOrder[i];
+        const slot parent = mParents[i];
+
+        // Parents have already been visited, so their flag says whether anything above this entity moved.
+        const bool dirty = all || hasChanged<Transform>(entity) || (parent != noParent && mDirty[parent]);
+        mDirty[i] = dirty;
+        if (!dirty) { continue; }
+
+        const auto &transform = getComponent<const Transform>(entity);
+        const glm::mat4 local = math::compose(transform.position, transform.rotation, transform.scale);
+        mWorldMatrices[i] = parent == noParent ? local : math::multiply(mWorldMatrices[parent], local);
+        getComponent<WorldTransform>(entity).matrix = mWorldMatrices[i];
+    }
+}
@@ -0,0 +1,131 @@
+/**
+ * @file CommandManager.cpp
+ * @brief Hands out a command buffer to each thread and plays all of them back at a sync point.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "CommandManager.h"
+#include "EntityManager.h"
+#include "ComponentManager.h"
+#include "SystemManager.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+    std::atomic<uint64_t> nextManagerId { 1 };
+
+    // The buffer that the calling thread last recorded into. Buffers are never freed before their manager is.
+    struct threadBuffer
+    {
+        uint64_t managerId { 0 };
+        CommandBuffer *buffer { nullptr };
+    };
+    thread_local threadBuffer cachedBuffer;
+}
+
+CommandManager::CommandManager()
+    : mId(nextManagerId.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+CommandBuffer &CommandManager::getCommandBuffer()
+{
+    if (cachedBuffer.managerId == mId) { return *cachedBuffer.buffer; }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto &buffer = mThreadBuffers[std::this_thread::get_id()];
+    if (!buffer)
+    {
+        mBuffers.push_back(std::make_unique<CommandBuffer>());
+        buffer = mBuffers.back().get();
+    }
+    cachedBuffer = { mId, buffer };
+    return *buffer;
+}
+
+void CommandManager::flush(EntityManager &entityManager, ComponentManager &componentManager,
+                           SystemManager &systemManager)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mPendingCommands.clear();
+    for (auto &buffer : mBuffers)
+    {
+        if (buffer->empty()) { continue; }
+
+        // Swap the placeholders for real entities now that we are back on a single thread.
+        std::vector<ecs::entity> createdEntities(buffer->mPlaceholderCount);
+        for (auto &entity : createdEntities) { entity = entityManager.createEntity(); }
+
+        for (auto &command : buffer->mCommands)
+        {
+            if (ecs::isPlaceholder(command.entity))
+            {
+                const ecs::entityIndex placeholder = ecs::indexOf(command.entity);
+                if (placeholder >= createdEntities.size())
+                {
+                    debug::log("A placeholder entity was used outside of the buffer that created it.",
+                               debug::severity::Fatal);
+                }
+                command.entity = createdEntities[placeholder];
+            }
+            mPendingCommands.push_back(std::move(command));
+        }
+        buffer->clear();
+    }
+
+    // Group the commands by entity. Stable so that each entity's commands keep their recorded order.
+    std::stable_sort(std::begin(mPendingCommands), std::end(mPendingCommands),
+                     [](const auto &lhs, const auto &rhs) { return lhs.entity < rhs.entity; });
+
+    auto groupStart = std::begin(mPendingCommands);
+    while (groupStart != std::end(mPendingCommands))
+    {
+        const ecs::entity entity = groupStart->entity;
+        const auto groupEnd = std::find_if(groupStart, std::end(mPendingCommands),
+                                           [entity](const auto &command) { return command.entity != entity; });
+
+        if (!entityManager.isAlive(entity))
+        {
+            debug::log("Commands were recorded for an entity that has since been destroyed.",
+                       debug::severity::Warning);
+            groupStart = groupEnd;
+            continue;
+        }
+
+        auto signature = entityManager.getSignature(entity);
+        bool isDestroyed = false;
+        for (auto it = groupStart; it != groupEnd && !isDestroyed; ++it)
+        {
+            switch (it->type)
+            {
+                case CommandBuffer::commandType::Add:
+                    it->apply(componentManager, entity);
+                    signature.set(it->componentId);
+                    break;
+                case CommandBuffer::commandType::Remove:
+                    it->apply(componentManager, entity);
+                    signature.reset(it->componentId);
+                    break;
+                case CommandBuffer::commandType::Destroy:
+                    entityManager.destroyEntity(entity);
+                    componentManager.entityDestroyed(entity);
+                    systemManager.entityDestroyed(entity);
+                    isDestroyed = true;
+                    break;
+            }
+        }
+
+        if (!isDestroyed)
+        {
+            entityManager.setSignature(entity, signature);
+            systemManager.entitySignatureChanged(entity, signature);
+        }
+        groupStart = groupEnd;
+    }
+    mPendingCommands.clear();
+}
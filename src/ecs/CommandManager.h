@@ -0,0 +1,49 @@
+#pragma once
+
+#include "EcsCommon.h"
+#include "CommandBuffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class EntityManager;
+class ComponentManager;
+class SystemManager;
+
+/**
+ * Hands out a command buffer to each thread and plays all of them back at a sync point.
+ * @author Ryan Purse
+ */
+class CommandManager
+{
+public:
+    CommandManager();
+
+    /**
+     * @return The command buffer that belongs to the calling thread. The buffer is cached per thread, so only a
+     * thread's first call takes the lock.
+     */
+    CommandBuffer &getCommandBuffer();
+
+    /**
+     * Plays back every command buffer. Commands are grouped by entity so that each entity's signature is only
+     * updated, and systems only notified, once no matter how many components were added or removed.
+     * Commands for a single entity from the same buffer are applied in the order they were recorded.
+     * @warning Must not be called while systems are running.
+     */
+    void flush(EntityManager &entityManager, ComponentManager &componentManager, SystemManager &systemManager);
+
+protected:
+    const uint64_t mId;  // Unique across every manager so that a thread's cache can't match one that was destroyed.
+    std::mutex mMutex;
+    std::vector<std::unique_ptr<CommandBuffer>> mBuffers;  // In creation order so that playback is repeatable.
+    std::unordered_map<std::thread::id, CommandBuffer *> mThreadBuffers;
+
+    // Kept between flushes so that its memory can be reused.
+    std::vector<CommandBuffer::command> mPendingCommands;
+};
+
@@ -1,8 +1,18 @@
 #pragma once
 
 #include "EcsCommon.h"
+#include "DebugLogger.h"
+#include "EntitySet.h"
+#include "Snapshot.h"
 
-#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 /**
@@ -12,7 +22,24 @@
 class IComponentArray
 {
 public:
-    virtual void entityDestroyed(ecs::entity entity) = 0;
+    virtual ~IComponentArray() = default;
+    /** Removes the entity's component if it has one. The removal counts as a change to the array at tick. */
+    virtual void entityDestroyed(ecs::entity entity, ecs::tick tick) = 0;
+
+    /** Removes every component. */
+    virtual void clear() = 0;
+
+    /** @return A name that identifies the component type in snapshots made by the same build. */
+    [[nodiscard]] virtual std::string getName() const = 0;
+
+    /** @return False if the component is not trivially copyable and no serializer has been registered. */
+    [[nodiscard]] virtual bool isSerializable() const = 0;
+
+    /** Writes the column, filling in where everything went apart from the name. */
+    virtual void save(SnapshotWriter &writer, ecs::snapshot::columnRecord &record) const = 0;
+
+    /** Replaces every component with the column in the snapshot. Loaded components count as changed at tick. */
+    virtual void load(SnapshotReader &reader, const ecs::snapshot::columnRecord &record, ecs::tick tick) = 0;
 };
 
 /**
@@ -24,62 +51,215 @@ class ComponentArray : public IComponentArray
 {
     typedef size_t index;
 public:
-    void insetData(ecs::entity entity, Component component)
+    typedef std::function<void(SnapshotWriter &, const Component &)> writeFunction;
+    typedef std::function<void(SnapshotReader &, Component &)> readFunction;
+
+    /** Constructs the component in place from args. It counts as changed at tick. */
+    template<typename... Args>
+    Component &emplaceData(ecs::entity entity, ecs::tick tick, Args &&...args)
     {
-        if (mEntityToIndexMap.find(entity) != std::end(mEntityToIndexMap))
+        if (mEntities.contains(entity))
         {
             debug::log(ecs::toString<Component>() + " already exists for this component.",
                        debug::severity::Fatal);
         }
 
-        index newIndex = mComponents.size();
-        mComponents.push_back(component);
-        mEntityToIndexMap[entity] = newIndex;
-        mIndexToEntityMap[newIndex] = entity;
+        // mEntities and mComponents are always kept in the same order.
+        mEntities.insert(entity);
+        Component &component = mComponents.emplace_back(std::forward<Args>(args)...);
+        mChangeTicks.push_back(tick);
+        markArrayChanged(tick);
+        return component;
+    }
+
+    /** Adds the component. It counts as changed at tick. */
+    void insetData(ecs::entity entity, const Component &component, ecs::tick tick)
+    {
+        emplaceData(entity, tick, component);
+    }
+
+    void insetData(ecs::entity entity, Component &&component, ecs::tick tick)
+    {
+        emplaceData(entity, tick, std::move(component));
     }
 
-    void removeData(ecs::entity entity)
+    /** Gives every entity a copy of component. Storage is only grown once. */
+    void insertData(const ecs::entity *entities, size_t count, const Component &component, ecs::tick tick)
     {
-        validateEntity(entity);
+        reserve(count);
+        for (size_t i = 0; i < count; ++i) { insetData(entities[i], component, tick); }
+    }
 
-        // Copy the elements at the end of the array into the deleted slot.
-        index indexOfRemovedElement = mEntityToIndexMap[entity];
+    /** Gives entities[i] components[i]. Storage is only grown once. */
+    void insertData(const ecs::entity *entities, std::span<const Component> components, ecs::tick tick)
+    {
+        reserve(components.size());
+        for (size_t i = 0; i < components.size(); ++i) { insetData(entities[i], components[i], tick); }
+    }
+
+    /** @param tick If set, the removal counts as a change to the array as a whole at tick. */
+    void removeData(ecs::entity entity, ecs::tick tick=0)
+    {
+        // Copy the elements at the end of the array into the deleted slot. The entity set does the same.
+        index indexOfRemovedElement = validateEntity(entity);
         index indexOfLastElement = mComponents.size() - 1;
         std::swap(mComponents[indexOfRemovedElement], mComponents[indexOfLastElement]);
         mComponents.pop_back();
+        mChangeTicks[indexOfRemovedElement] = mChangeTicks[indexOfLastElement];
+        mChangeTicks.pop_back();
 
-        // Update the maps to point to the new spot.
-        auto entityOfLastElement = mIndexToEntityMap[indexOfLastElement];
-        mEntityToIndexMap[entityOfLastElement] = indexOfRemovedElement;
-        mIndexToEntityMap[indexOfRemovedElement] = entityOfLastElement;
+        mEntities.erase(entity);
+        if (tick != 0) { markArrayChanged(tick); }
+    }
 
-        mEntityToIndexMap.erase(entity);
-        mIndexToEntityMap.erase(indexOfLastElement);
+    [[nodiscard]] bool hasData(ecs::entity entity) const { return mEntities.contains(entity); }
+
+    /** Read only access. Does not count as a change. */
+    [[nodiscard]] const Component &getData(ecs::entity entity) const
+    {
+        return mComponents[validateEntity(entity)];
+    }
+
+    /** Write access. The component counts as changed at tick. */
+    [[nodiscard]] Component &getData(ecs::entity entity, ecs::tick tick)
+    {
+        const index i = validateEntity(entity);
+        mChangeTicks[i] = tick;
+        markArrayChanged(tick);
+        return mComponents[i];
     }
 
-    [[nodiscard]] Component &getData(ecs::entity entity)
+    /** @return The last tick that the entity's component was written to. */
+    [[nodiscard]] ecs::tick getChangeTick(ecs::entity entity) const
     {
-        validateEntity(entity);
-        return mComponents[mEntityToIndexMap[entity]];
+        return mChangeTicks[validateEntity(entity)];
     }
 
-    void entityDestroyed(ecs::entity entity) override
+    /** @return The last tick that any component in the array was written to. */
+    [[nodiscard]] ecs::tick getLastChangeTick() const
     {
-        removeData(entity);
+        return mLastChangeTick.load(std::memory_order_relaxed);
+    }
+
+    void entityDestroyed(ecs::entity entity, ecs::tick tick) override
+    {
+        // Not every entity has every component.
+        if (mEntities.contains(entity)) { removeData(entity, tick); }
+    }
+
+    void clear() override
+    {
+        mComponents.clear();
+        mChangeTicks.clear();
+        mEntities.clear();
+    }
+
+    [[nodiscard]] std::string getName() const override { return ecs::toString<Component>(); }
+
+    /** Used instead of a raw copy when saving and loading snapshots. */
+    void setSerializer(writeFunction write, readFunction read)
+    {
+        mWrite = std::move(write);
+        mRead = std::move(read);
+    }
+
+    [[nodiscard]] bool isSerializable() const override
+    {
+        return mWrite != nullptr || std::is_trivially_copyable_v<Component>;
+    }
+
+    void save(SnapshotWriter &writer, ecs::snapshot::columnRecord &record) const override
+    {
+        record.count = mComponents.size();
+        record.elementSize = sizeof(Component);
+        record.entitiesOffset = writer.writeArray(mEntities.data(), mEntities.size());
+        if (mWrite)
+        {
+            writer.align();
+            record.dataOffset = writer.offset();
+            for (const Component &component : mComponents) { mWrite(writer, component); }
+        }
+        else if constexpr (std::is_trivially_copyable_v<Component>)
+        {
+            // The column is written exactly as it is laid out in memory, so loading it is a single copy.
+            record.dataOffset = writer.writeArray(mComponents.data(), mComponents.size());
+            record.isRaw = 1;
+        }
+        record.dataSize = writer.offset() - record.dataOffset;
+    }
+
+    void load(SnapshotReader &reader, const ecs::snapshot::columnRecord &record, ecs::tick tick) override
+    {
+        const bool canRead = record.isRaw ? std::is_trivially_copyable_v<Component> : mRead != nullptr;
+        if (record.elementSize != sizeof(Component) || !canRead)
+        {
+            debug::log("Snapshot column " + getName() + " does not match this build.", debug::severity::Fatal);
+        }
+
+        const auto count = static_cast<size_t>(record.count);
+        std::vector<ecs::entity> entities(count);
+        reader.readArray(record.entitiesOffset, entities.data(), count);
+
+        clear();
+        mComponents.resize(count);
+        if constexpr (std::is_trivially_copyable_v<Component>)
+        {
+            if (record.isRaw) { reader.readArray(record.dataOffset, mComponents.data(), count); }
+        }
+        if (!record.isRaw)
+        {
+            reader.seek(record.dataOffset);
+            for (Component &component : mComponents) { mRead(reader, component); }
+        }
+
+        mEntities.reserve(count);
+        for (const ecs::entity entity : entities) { mEntities.insert(entity); }
+        if (mEntities.size() != count)
+        {
+            debug::log("Snapshot column " + getName() + " has duplicate entities.", debug::severity::Fatal);
+        }
+        mChangeTicks.assign(count, tick);
+        markArrayChanged(tick);
     }
 
 protected:
-    void validateEntity(ecs::entity entity)
+    void reserve(size_t additionalCount)
     {
-        if (mEntityToIndexMap.find(entity) == std::end(mEntityToIndexMap))
+        const size_t required = mComponents.size() + additionalCount;
+        if (required > mComponents.capacity())
+        {
+            mComponents.reserve(std::max(required, mComponents.capacity() * 2));
+            mChangeTicks.reserve(mComponents.capacity());
+        }
+        mEntities.reserveAdditional(additionalCount);
+    }
+
+    void markArrayChanged(ecs::tick tick)
+    {
+        // Only one system may write to an array at a time and all of its threads share the same tick, so racing
+        // threads always store the same value. Checking first stops them from fighting over the cache line.
+        if (mLastChangeTick.load(std::memory_order_relaxed) < tick)
+        {
+            mLastChangeTick.store(tick, std::memory_order_relaxed);
+        }
+    }
+
+    index validateEntity(ecs::entity entity) const
+    {
+        const index i = mEntities.find(entity);
+        if (i == EntitySet::invalidIndex)
         {
             debug::log("An entity with this component does not exist.", debug::severity::Fatal);
         }
+        return i;
     }
 
     std::vector<Component> mComponents;  // Components must be contiguous to help cache lines.
-    std::unordered_map<ecs::entity, index> mEntityToIndexMap;
-    std::unordered_map<index, ecs::entity> mIndexToEntityMap;
-};
+    EntitySet mEntities;                 // The entity that owns each component in mComponents.
+    std::vector<ecs::tick> mChangeTicks;  // When each component in mComponents was last written to.
+    std::atomic<ecs::tick> mLastChangeTick { 0 };
 
+    writeFunction mWrite;
+    readFunction mRead;
+};
 
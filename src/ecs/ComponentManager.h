@@ -1,10 +1,17 @@
 #pragma once
 
 #include "EcsCommon.h"
+#include "DebugLogger.h"
 #include "ComponentArray.h"
 
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <string>
+#include <type_traits>
+#include <vector>
 #include <memory>
+#include <span>
 
 /**
  * Handles all of the component arrays.
@@ -16,71 +23,198 @@ public:
     template<typename Component>
     void registerComponent()
     {
-        auto typeId = typeid(Component).hash_code();
-        if (mComponentIds.find(typeId) != std::end(mComponentIds))
+        const ecs::componentId id = ecs::assignTypeIndex<ecs::componentFamily, Component>();
+        if (id >= ecs::maxComponents)
+        {
+            debug::log("Component " + ecs::toString<Component>() + " exceeds the maximum amount of components.",
+                       debug::severity::Fatal);
+        }
+        if (mComponentArrays[id])
         {
             debug::log("Component " + ecs::toString<Component>() + " has already been registered.",
                        debug::severity::Fatal);
         }
 
-        // Add the component to the component Id map.
-        mComponentIds.insert({ typeId, mNextComponentId++ });
-
-        // Create a component array pointer and add it to the component array map.
-        mComponentArrays.insert({ typeId, std::make_shared<ComponentArray<Component>>() });
+        // Component arrays are stored by their id so that finding one is an array index.
+        mComponentArrays[id] = std::make_unique<ComponentArray<Component>>();
+        mRegisteredIds.push_back(id);
     }
 
     template<typename Component>
     ecs::componentId getComponentId()
     {
-        auto typeId = typeid(Component).hash_code();
-        validateComponent(typeId);
-        return mComponentIds[typeId];
+        const ecs::componentId id = ecs::typeIndex<ecs::componentFamily, Component>;
+        validateComponent(id);
+        return id;
+    }
+
+    template<typename Component>
+    void addComponent(ecs::entity entity, Component &&component)
+    {
+        getComponentArray<std::remove_cvref_t<Component>>()->insetData(
+                entity, std::forward<Component>(component), advanceTick());
+    }
+
+    template<typename Component, typename... Args>
+    Component &emplaceComponent(ecs::entity entity, Args &&...args)
+    {
+        return getComponentArray<Component>()->emplaceData(entity, advanceTick(), std::forward<Args>(args)...);
+    }
+
+    /** Gives every entity a copy of component. */
+    template<typename Component>
+    void addComponents(const ecs::entity *entities, size_t count, const Component &component)
+    {
+        getComponentArray<Component>()->insertData(entities, count, component, advanceTick());
     }
 
+    /** Gives entities[i] components[i]. */
     template<typename Component>
-    void addComponent(ecs::entity entity, Component component)
+    void addComponents(const ecs::entity *entities, std::span<const Component> components)
     {
-        getComponentArray<Component>()->insetData(entity, component);
+        getComponentArray<Component>()->insertData(entities, components, advanceTick());
     }
 
+    /** Removing a component counts as a change to its array, so systems can tell that something went. */
     template<typename Component>
     void removeComponent(ecs::entity entity)
     {
-        getComponentArray<Component>()->removeData(entity);
+        getComponentArray<Component>()->removeData(entity, advanceTick());
     }
 
     template<typename Component>
-    Component &getComponent(ecs::entity entity)
+    [[nodiscard]] bool hasComponent(ecs::entity entity)
+    {
+        return getComponentArray<std::remove_const_t<Component>>()->hasData(entity);
+    }
+
+    /**
+     * A const Component gives read only access. Otherwise the component counts as changed at tick, which defaults
+     * to a new tick so that every system sees the change.
+     */
+    template<typename Component>
+    Component &getComponent(ecs::entity entity, ecs::tick tick=0)
+    {
+        auto *componentArray = getComponentArray<std::remove_const_t<Component>>();
+        if constexpr (std::is_const_v<Component>)
+        {
+            return componentArray->getData(entity);
+        }
+        else
+        {
+            return componentArray->getData(entity, tick == 0 ? advanceTick() : tick);
+        }
+    }
+
+    /** @return A tick that is later than every tick handed out so far. */
+    ecs::tick advanceTick()
     {
-        return getComponentArray<Component>()->getData(entity);
+        return mChangeTick.fetch_add(1, std::memory_order_relaxed) + 1;
     }
 
     void entityDestroyed(ecs::entity entity)
     {
-        for (auto &[_, component] : mComponentArrays) { component->entityDestroyed(entity); }
+        const ecs::tick tick = advanceTick();
+        for (const auto id : mRegisteredIds) { mComponentArrays[id]->entityDestroyed(entity, tick); }
     }
 
-protected:
     template<typename Component>
-    std::shared_ptr<ComponentArray<Component>> getComponentArray()
+    void setSerializer(typename ComponentArray<Component>::writeFunction write,
+                       typename ComponentArray<Component>::readFunction read)
     {
-        auto typeId = typeid(Component).hash_code();
-        validateComponent(typeId);
-        return std::static_pointer_cast<ComponentArray<Component>>(mComponentArrays[typeId]);
+        getComponentArray<Component>()->setSerializer(std::move(write), std::move(read));
     }
 
-    void validateComponent(size_t typeId)
+    /** Writes every component array that can be serialised followed by the column table. */
+    void save(SnapshotWriter &writer, ecs::snapshot::fileHeader &header) const
     {
-        if (mComponentIds.find(typeId) == std::end(mComponentIds))
+        std::vector<ecs::snapshot::columnRecord> records;
+        for (const auto id : mRegisteredIds)
+        {
+            const IComponentArray &componentArray = *mComponentArrays[id];
+            const std::string name = componentArray.getName();
+            if (!componentArray.isSerializable())
+            {
+                debug::log("Component " + name + " has no serializer and is left out of the snapshot.",
+                           debug::severity::Warning);
+                continue;
+            }
+
+            ecs::snapshot::columnRecord record;
+            record.componentId = static_cast<uint32_t>(id);
+            record.nameOffset = writer.writeArray(name.data(), name.size());
+            record.nameLength = name.size();
+            componentArray.save(writer, record);
+            records.push_back(record);
+        }
+
+        header.columnCount = records.size();
+        header.columnTableOffset = writer.writeArray(records.data(), records.size());
+    }
+
+    /**
+     * Replaces every component with the columns in the snapshot. Columns are matched to arrays by name.
+     * @return The current id of each component id in the snapshot, or invalidId if it wasn't loaded.
+     */
+    std::array<ecs::componentId, ecs::maxComponents> load(SnapshotReader &reader,
+                                                          const ecs::snapshot::fileHeader &header)
+    {
+        if (header.columnCount > ecs::maxComponents)
+        {
+            debug::log("Snapshot has more columns than there can be components.", debug::severity::Fatal);
+        }
+        std::vector<ecs::snapshot::columnRecord> records(static_cast<size_t>(header.columnCount));
+        reader.readArray(header.columnTableOffset, records.data(), records.size());
+
+        for (const auto id : mRegisteredIds) { mComponentArrays[id]->clear(); }
+
+        std::array<ecs::componentId, ecs::maxComponents> componentIds;
+        componentIds.fill(ecs::invalidId);
+        const ecs::tick tick = advanceTick();
+        for (const auto &record : records)
+        {
+            std::string name(static_cast<size_t>(std::min<uint64_t>(record.nameLength, 4096)), '\0');
+            reader.readArray(record.nameOffset, name.data(), name.size());
+
+            const auto it = std::find_if(mRegisteredIds.begin(), mRegisteredIds.end(), [&](ecs::componentId id) {
+                return mComponentArrays[id]->getName() == name;
+            });
+            if (it == mRegisteredIds.end() || record.componentId >= ecs::maxComponents)
+            {
+                debug::log("Snapshot component " + name + " has not been registered and is skipped.",
+                           debug::severity::Warning);
+                continue;
+            }
+
+            mComponentArrays[*it]->load(reader, record, tick);
+            componentIds[record.componentId] = *it;
+        }
+        return componentIds;
+    }
+
+    /**
+     * Resolves the array that holds every Component. The pointer stays valid for the lifetime of the manager,
+     * so queries can look it up once and reuse it for every entity.
+     */
+    template<typename Component>
+    ComponentArray<Component> *getComponentArray()
+    {
+        const ecs::componentId id = ecs::typeIndex<ecs::componentFamily, Component>;
+        validateComponent(id);
+        return static_cast<ComponentArray<Component> *>(mComponentArrays[id].get());
+    }
+
+protected:
+    void validateComponent(ecs::componentId id)
+    {
+        if (id >= ecs::maxComponents || !mComponentArrays[id])
         {
             debug::log("Component has not been registered before use.", debug::severity::Fatal);
         }
     }
 
-    std::unordered_map<size_t, ecs::componentId> mComponentIds;
-    std::unordered_map<size_t, std::shared_ptr<IComponentArray>> mComponentArrays;
-    ecs::componentId mNextComponentId{ 0 };
+    std::array<std::unique_ptr<IComponentArray>, ecs::maxComponents> mComponentArrays;
+    std::vector<ecs::componentId> mRegisteredIds;
+    std::atomic<ecs::tick> mChangeTick { 0 };  // Tick zero is never handed out.
 };
 
-
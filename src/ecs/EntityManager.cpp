@@ -7,41 +7,163 @@
  */
 
 #include "EntityManager.h"
+#include "DebugLogger.h"
+
+#include <algorithm>
 
 ecs::entity EntityManager::createEntity()
 {
-    if (mNextId == ecs::maxEntities)
+    ++mCount;
+    if (!mFreeIndices.empty())
+    {
+        // Recycle an index. Its generation was bumped when it was destroyed.
+        const ecs::entityIndex index = mFreeIndices.back();
+        mFreeIndices.pop_back();
+        return ecs::makeEntity(index, mGenerations[index]);
+    }
+
+    if (mGenerations.size() == ecs::maxEntities)
     {
         debug::log("Maximum amount of entities have already been created.\n"
                    "Cannot deduce the next UUID for this entity.",
                    debug::severity::Fatal);
     }
-    mEntityMap[mNextId] = ecs::signature();
-    return mNextId++;
+    const auto index = static_cast<ecs::entityIndex>(mGenerations.size());
+    mGenerations.push_back(0);
+    mSignatures.emplace_back();
+    return ecs::makeEntity(index, 0);
+}
+
+std::vector<ecs::entity> EntityManager::createEntities(size_t count)
+{
+    std::vector<ecs::entity> entities;
+    entities.reserve(count);
+
+    while (entities.size() < count && !mFreeIndices.empty())
+    {
+        const ecs::entityIndex index = mFreeIndices.back();
+        mFreeIndices.pop_back();
+        entities.push_back(ecs::makeEntity(index, mGenerations[index]));
+    }
+
+    const size_t newCount = count - entities.size();
+    const size_t firstIndex = mGenerations.size();
+    if (firstIndex + newCount > ecs::maxEntities)
+    {
+        debug::log("Not enough space to create " + std::to_string(count) + " entities.", debug::severity::Fatal);
+    }
+    mGenerations.resize(firstIndex + newCount, 0);
+    mSignatures.resize(firstIndex + newCount);
+    for (size_t i = 0; i < newCount; ++i)
+    {
+        entities.push_back(ecs::makeEntity(static_cast<ecs::entityIndex>(firstIndex + i), 0));
+    }
+
+    mCount += count;
+    return entities;
 }
 
 void EntityManager::destroyEntity(ecs::entity entity)
 {
     validateEntity(entity);
-    mEntityMap.erase(entity);
+    const ecs::entityIndex index = ecs::indexOf(entity);
+    mSignatures[index].reset();
+    // Any handles that are still around are now stale.
+    if (++mGenerations[index] == ecs::placeholderGeneration) { mGenerations[index] = 0; }
+    mFreeIndices.push_back(index);
+    --mCount;
+}
+
+bool EntityManager::isAlive(ecs::entity entity) const
+{
+    const ecs::entityIndex index = ecs::indexOf(entity);
+    return index < mGenerations.size() && mGenerations[index] == ecs::generationOf(entity);
 }
 
 void EntityManager::setSignature(ecs::entity entity, ecs::signature signature)
 {
     validateEntity(entity);
-    mEntityMap[entity] = signature;
+    mSignatures[ecs::indexOf(entity)] = signature;
+}
+
+void EntityManager::setSignature(const ecs::entity *entities, size_t count, ecs::signature signature)
+{
+    for (size_t i = 0; i < count; ++i) { setSignature(entities[i], signature); }
 }
 
 ecs::signature EntityManager::getSignature(ecs::entity entity)
 {
     validateEntity(entity);
-    return mEntityMap[entity];
+    return mSignatures[ecs::indexOf(entity)];
+}
+
+void EntityManager::save(SnapshotWriter &writer, ecs::snapshot::fileHeader &header) const
+{
+    // Bitsets have no fixed layout, so signatures are stored as plain integers.
+    std::vector<uint32_t> signatures(mSignatures.size());
+    std::transform(mSignatures.begin(), mSignatures.end(), signatures.begin(), [](const ecs::signature &signature) {
+        return static_cast<uint32_t>(signature.to_ulong());
+    });
+
+    header.entitySlots = mGenerations.size();
+    header.freeCount = mFreeIndices.size();
+    header.aliveCount = mCount;
+    header.generationsOffset = writer.writeArray(mGenerations.data(), mGenerations.size());
+    header.signaturesOffset = writer.writeArray(signatures.data(), signatures.size());
+    header.freeIndicesOffset = writer.writeArray(mFreeIndices.data(), mFreeIndices.size());
+}
+
+std::vector<ecs::entity> EntityManager::load(SnapshotReader &reader, const ecs::snapshot::fileHeader &header,
+                                             const std::array<ecs::componentId, ecs::maxComponents> &componentIds)
+{
+    if (header.entitySlots > ecs::maxEntities || header.freeCount > header.entitySlots
+        || header.aliveCount != header.entitySlots - header.freeCount)
+    {
+        debug::log("Snapshot has an invalid entity table.", debug::severity::Fatal);
+    }
+
+    const auto slots = static_cast<size_t>(header.entitySlots);
+    std::vector<uint32_t> signatures(slots);
+    mGenerations.resize(slots);
+    mFreeIndices.resize(static_cast<size_t>(header.freeCount));
+    reader.readArray(header.generationsOffset, mGenerations.data(), slots);
+    reader.readArray(header.signaturesOffset, signatures.data(), slots);
+    reader.readArray(header.freeIndicesOffset, mFreeIndices.data(), mFreeIndices.size());
+
+    // Components may have been registered in a different order, or not at all, since the snapshot was made.
+    mSignatures.assign(slots, ecs::signature());
+    for (size_t i = 0; i < slots; ++i)
+    {
+        for (size_t bit = 0; bit < ecs::maxComponents; ++bit)
+        {
+            if ((signatures[i] >> bit & 1u) != 0 && componentIds[bit] != ecs::invalidId)
+            {
+                mSignatures[i].set(componentIds[bit]);
+            }
+        }
+    }
+    mCount = static_cast<size_t>(header.aliveCount);
+
+    std::vector<bool> isFree(slots, false);
+    for (const ecs::entityIndex index : mFreeIndices)
+    {
+        if (index >= slots) { debug::log("Snapshot has an invalid free list.", debug::severity::Fatal); }
+        isFree[index] = true;
+    }
+
+    std::vector<ecs::entity> alive;
+    alive.reserve(mCount);
+    for (size_t i = 0; i < slots; ++i)
+    {
+        if (!isFree[i]) { alive.push_back(ecs::makeEntity(static_cast<ecs::entityIndex>(i), mGenerations[i])); }
+    }
+    return alive;
 }
 
-void EntityManager::validateEntity(ecs::entity entity)
+void EntityManager::validateEntity(ecs::entity entity) const
 {
-    if (mEntityMap.find(entity) == std::end(mEntityMap))
+    if (!isAlive(entity))
     {
-        debug::log("Entity does not exist.",debug::severity::Fatal);
+        debug::log("Entity does not exist or has already been destroyed.", debug::severity::Fatal);
     }
 }
@@ -1,9 +1,10 @@
 #pragma once
 
 #include "EcsCommon.h"
+#include "Snapshot.h"
 
+#include <array>
 #include <vector>
-#include <unordered_map>
 
 /**
  * Records all Alive Entities and handles all UUID's.
@@ -15,14 +16,38 @@ public:
     ecs::entity createEntity();
     void destroyEntity(ecs::entity);
 
+    /** Creates count entities at once. Recycled indices are used up first and storage is then grown once. */
+    std::vector<ecs::entity> createEntities(size_t count);
+
+    /** @return True if the entity has been created and has not been destroyed since. */
+    [[nodiscard]] bool isAlive(ecs::entity entity) const;
+
     void setSignature(ecs::entity entity, ecs::signature signature);
+    void setSignature(const ecs::entity *entities, size_t count, ecs::signature signature);
     ecs::signature getSignature(ecs::entity entity);
 
+    [[nodiscard]] size_t size() const { return mCount; }
+
+    /** Writes the generations, signatures and free list, filling in their part of the header. */
+    void save(SnapshotWriter &writer, ecs::snapshot::fileHeader &header) const;
+
+    /**
+     * Replaces every entity with the ones in the snapshot.
+     * @param componentIds Maps the component ids in the saved signatures onto the current ones.
+     * @return The entities that are alive.
+     */
+    std::vector<ecs::entity> load(SnapshotReader &reader, const ecs::snapshot::fileHeader &header,
+                                  const std::array<ecs::componentId, ecs::maxComponents> &componentIds);
+
 protected:
-    void validateEntity(ecs::entity entity);
-    size_t mNextId{ 0 };
-    std::unordered_map<ecs::entity, ecs::signature> mEntityMap;
+    void validateEntity(ecs::entity entity) const;
+
+    // All of these are indexed by an entity's index.
+    std::vector<ecs::signature> mSignatures;
+    std::vector<ecs::entityGeneration> mGenerations;
+
+    // Indices of destroyed entities that can be handed out again.
+    std::vector<ecs::entityIndex> mFreeIndices;
     size_t mCount{ 0 };
 };
 
-
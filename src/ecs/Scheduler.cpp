@@ -0,0 +1,180 @@
+/**
+ * @file Scheduler.cpp
+ * @brief Runs systems concurrently based on the components that they read and write.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "Scheduler.h"
+#include "DebugLogger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+void Scheduler::add(std::shared_ptr<System> system, std::string name, ecs::signature reads, ecs::signature writes,
+                    ecs::thread affinity)
+{
+    node newNode;
+    newNode.name = std::move(name);
+    newNode.system = std::move(system);
+    newNode.reads = reads;
+    newNode.writes = writes;
+    newNode.affinity = affinity;
+    mNodes.push_back(std::move(newNode));
+    mIsDirty = true;
+}
+
+bool Scheduler::conflicts(const Scheduler::node &first, const Scheduler::node &second)
+{
+    // Two readers never conflict. Anything else touching a component that is being written to does.
+    return (first.writes & (second.reads | second.writes)).any() || (first.reads & second.writes).any();
+}
+
+void Scheduler::build()
+{
+    for (auto &current : mNodes)
+    {
+        current.dependents.clear();
+        current.dependencies.clear();
+        current.stage = 0;
+    }
+
+    // Conflicting systems keep the order that they were added in, so the result is deterministic.
+    for (size_t i = 0; i < mNodes.size(); ++i)
+    {
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (!conflicts(mNodes[j], mNodes[i])) { continue; }
+            mNodes[j].dependents.push_back(i);
+            mNodes[i].dependencies.push_back(j);
+            mNodes[i].stage = std::max(mNodes[i].stage, mNodes[j].stage + 1);
+        }
+    }
+
+    mRemainingDependencies = std::make_unique<std::atomic<size_t>[]>(mNodes.size());
+    mMainThreadQueue.reserve(mNodes.size());
+    mIsDirty = false;
+
+    debug::log(describe(), debug::severity::Notification);
+}
+
+void Scheduler::run(float deltaTime, ThreadPool &pool)
+{
+    if (mIsDirty) { build(); }
+
+    for (size_t i = 0; i < mNodes.size(); ++i)
+    {
+        mRemainingDependencies[i].store(mNodes[i].dependencies.size(), std::memory_order_relaxed);
+    }
+    mCompletedCount.store(0, std::memory_order_release);
+
+    for (size_t i = 0; i < mNodes.size(); ++i)
+    {
+        if (mNodes[i].dependencies.empty()) { dispatch(i, deltaTime, pool); }
+    }
+
+    // The calling thread runs the main thread systems and otherwise helps the pool until everything is done.
+    while (mCompletedCount.load(std::memory_order_acquire) < mNodes.size())
+    {
+        size_t index = mNodes.size();
+        {
+            std::lock_guard<std::mutex> lock(mMainThreadMutex);
+            if (!mMainThreadQueue.empty())
+            {
+                index = mMainThreadQueue.back();
+                mMainThreadQueue.pop_back();
+            }
+        }
+
+        if (index < mNodes.size()) { execute(index, deltaTime, pool); }
+        else if (!pool.tryRunPendingTask()) { std::this_thread::yield(); }
+    }
+
+    if (mException)
+    {
+        std::exception_ptr exception = mException;
+        mException = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+void Scheduler::dispatch(size_t index, float deltaTime, ThreadPool &pool)
+{
+    if (mNodes[index].affinity == ecs::thread::Main)
+    {
+        std::lock_guard<std::mutex> lock(mMainThreadMutex);
+        mMainThreadQueue.push_back(index);
+        return;
+    }
+    pool.submit([this, index, deltaTime, &pool]() { execute(index, deltaTime, pool); });
+}
+
+void Scheduler::execute(size_t index, float deltaTime, ThreadPool &pool)
+{
+    auto &current = mNodes[index];
+    const auto start = std::chrono::steady_clock::now();
+    try
+    {
+        current.system->beginRun();
+        current.system->update(deltaTime);
+    }
+    catch (...)
+    {
+        // Logging throws when something is fatal. Pass it on to the thread that is running the schedule.
+        std::lock_guard<std::mutex> lock(mExceptionMutex);
+        if (!mException) { mException = std::current_exception(); }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    current.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+    for (const size_t dependent : current.dependents)
+    {
+        if (mRemainingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            dispatch(dependent, deltaTime, pool);
+        }
+    }
+    mCompletedCount.fetch_add(1, std::memory_order_acq_rel);
+}
+
+std::vector<Scheduler::systemTiming> Scheduler::getTimings() const
+{
+    std::vector<systemTiming> timings;
+    timings.reserve(mNodes.size());
+    for (const auto &current : mNodes)
+    {
+        timings.push_back({ current.name, current.stage, current.milliseconds });
+    }
+    return timings;
+}
+
+std::string Scheduler::describe() const
+{
+    std::stringstream ss;
+    ss << "System Schedule (" << mNodes.size() << " systems)\n";
+
+    size_t lastStage = 0;
+    for (const auto &current : mNodes) { lastStage = std::max(lastStage, current.stage); }
+
+    for (size_t stage = 0; stage <= lastStage && !mNodes.empty(); ++stage)
+    {
+        ss << "  Stage " << stage << ":\n";
+        for (const auto &current : mNodes)
+        {
+            if (current.stage != stage) { continue; }
+
+            ss << "    " << current.name;
+            if (current.affinity == ecs::thread::Main) { ss << " [main thread]"; }
+            ss << " (" << current.milliseconds << "ms)";
+            if (!current.dependencies.empty())
+            {
+                ss << " after:";
+                for (const size_t dependency : current.dependencies) { ss << " " << mNodes[dependency].name; }
+            }
+            ss << "\n";
+        }
+    }
+    return ss.str();
+}
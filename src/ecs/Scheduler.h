@@ -0,0 +1,83 @@
+#pragma once
+
+#include "EcsCommon.h"
+#include "System.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Runs systems each frame. Systems declare the components they read and write and any two systems that conflict
+ * are run in the order they were added. Everything else is run concurrently on a thread pool.
+ * @author Ryan Purse
+ */
+class Scheduler
+{
+    struct node
+    {
+        std::string name;
+        std::shared_ptr<System> system;
+        ecs::signature reads;
+        ecs::signature writes;
+        ecs::thread affinity { ecs::thread::Any };
+
+        std::vector<size_t> dependents;     // Nodes that cannot start until this node is done.
+        std::vector<size_t> dependencies;
+        size_t stage { 0 };                 // Length of the longest chain of dependencies before this node.
+        double milliseconds { 0.0 };        // How long the last update took.
+    };
+public:
+    struct systemTiming
+    {
+        std::string_view name;
+        size_t stage;
+        double milliseconds;
+    };
+
+    /**
+     * Adds a system to the schedule. Systems that conflict with ones that have already been added run after them.
+     * @param reads Components that the system only reads from.
+     * @param writes Components that the system writes to.
+     * @param affinity Set to Main if the system must not be run from a worker thread.
+     */
+    void add(std::shared_ptr<System> system, std::string name, ecs::signature reads, ecs::signature writes,
+             ecs::thread affinity);
+
+    /**
+     * Runs every system once. Returns when all of them have finished.
+     * Any exception thrown by a system is rethrown here on the calling thread.
+     */
+    void run(float deltaTime, ThreadPool &pool);
+
+    /** @return Each system with its stage and how long it took the last time it was run. */
+    [[nodiscard]] std::vector<systemTiming> getTimings() const;
+
+    /** @return A human readable dump of the schedule. */
+    [[nodiscard]] std::string describe() const;
+
+protected:
+    void build();
+    void dispatch(size_t index, float deltaTime, ThreadPool &pool);
+    void execute(size_t index, float deltaTime, ThreadPool &pool);
+    [[nodiscard]] static bool conflicts(const node &first, const node &second);
+
+    std::vector<node> mNodes;
+    bool mIsDirty { false };
+
+    // Per run state.
+    std::unique_ptr<std::atomic<size_t>[]> mRemainingDependencies;
+    std::atomic<size_t> mCompletedCount { 0 };
+
+    std::mutex mMainThreadMutex;
+    std::vector<size_t> mMainThreadQueue;
+
+    std::mutex mExceptionMutex;
+    std::exception_ptr mException;
+};
+
@@ -0,0 +1,48 @@
+/**
+ * @file Snapshot.cpp
+ * @brief Reads and writes binary snapshots of the ECS world.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "Snapshot.h"
+#include "DebugLogger.h"
+
+#include <fstream>
+
+void SnapshotWriter::saveToFile(std::string_view path) const
+{
+    std::ofstream file(std::string(path), std::ios_base::binary | std::ios_base::trunc);
+    if (!file)
+    {
+        debug::log("Could not open " + std::string(path) + " to write a snapshot.", debug::severity::Major);
+        return;
+    }
+    file.write(reinterpret_cast<const char *>(mBuffer.data()), static_cast<std::streamsize>(mBuffer.size()));
+}
+
+SnapshotReader::SnapshotReader(std::string_view path)
+{
+    std::ifstream file(std::string(path), std::ios_base::binary | std::ios_base::ate);
+    if (!file)
+    {
+        debug::log("Could not open snapshot " + std::string(path) + ".", debug::severity::Major);
+        return;
+    }
+
+    // One read for the whole file. The layout is offset based so nothing needs to be parsed up front.
+    const std::streamsize size = file.tellg();
+    file.seekg(0);
+    mBuffer.resize(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char *>(mBuffer.data()), size);
+}
+
+void SnapshotReader::validateRange(size_t at, uint64_t count, size_t elementSize) const
+{
+    // Divided rather than multiplied so that a corrupt count can't overflow.
+    if (at > mBuffer.size() || count > (mBuffer.size() - at) / elementSize)
+    {
+        debug::log("Snapshot is truncated or corrupt.", debug::severity::Fatal);
+    }
+}
@@ -1,9 +1,10 @@
 #pragma once
 
 #include "EcsCommon.h"
+#include "DebugLogger.h"
 #include "System.h"
 
-#include <unordered_map>
+#include <vector>
 #include <memory>
 
 /**
@@ -12,30 +13,40 @@
  */
 class SystemManager
 {
+    /** Systems are kept contiguous so that signature changes are a linear walk with no lookups. */
+    struct systemRecord
+    {
+        ecs::signature signature;
+        std::shared_ptr<System> system;
+    };
 public:
     template<typename sys>
     std::shared_ptr<sys> registerSystem()
     {
-        auto typeId = typeid(sys).hash_code();
-        if (mSystems.find(typeId) != std::end(mSystems))
+        const ecs::systemId id = ecs::assignTypeIndex<ecs::systemFamily, sys>();
+        if (id < mSystemIndices.size() && mSystemIndices[id] != ecs::invalidId)
         {
             debug::log("System " + ecs::toString<sys>() + " has already been registered.",
                     debug::severity::Fatal);
         }
+        if (id >= mSystemIndices.size()) { mSystemIndices.resize(id + 1, ecs::invalidId); }
+
         auto system = std::make_shared<sys>();
-        mSystems.insert({ typeId, system });
+        mSystemIndices[id] = mSystems.size();
+        mSystems.push_back({ ecs::signature(), system });
         return system;
     }
 
     template<typename sys>
     void setSignature(ecs::signature signature)
     {
-        auto typeId = typeid(sys).hash_code();
-        if (mSystems.find(typeId) == std::end(mSystems))
-        {
-            debug::log("System " + ecs::toString<sys>() + " has not been registered.", debug::severity::Fatal);
-        }
-        mSignatures.insert({ typeId, signature });
+        mSystems[validateSystem<sys>()].signature = signature;
+    }
+
+    template<typename sys>
+    std::shared_ptr<sys> getSystem()
+    {
+        return std::static_pointer_cast<sys>(mSystems[validateSystem<sys>()].system);
     }
 
     void entityDestroyed(ecs::entity entity)
@@ -44,12 +55,17 @@ public:
         for (const auto &[_, system] : mSystems) { system->mEntities.erase(entity); }
     }
 
+    /** Empties every system's list of entities. */
+    void clearEntities()
+    {
+        for (const auto &[_, system] : mSystems) { system->mEntities.clear(); }
+    }
+
     void entitySignatureChanged(ecs::entity entity, ecs::signature entitySignature)
     {
         // Notify each system that an entity's signature changed.
-        for (const auto &[type, system] : mSystems)
+        for (const auto &[systemSignature, system] : mSystems)
         {
-            const auto &systemSignature = mSignatures[type];
             if ((entitySignature & systemSignature) == systemSignature)
             {
                 system->mEntities.insert(entity);
@@ -61,12 +77,38 @@ public:
         }
     }
 
-protected:
-    // Map from system type id to a signature.
-    std::unordered_map<size_t, ecs::signature> mSignatures;
+    /** Notifies each system once about a group of entities that all share the same signature. */
+    void entitySignatureChanged(const ecs::entity *entities, size_t count, ecs::signature entitySignature)
+    {
+        for (const auto &[systemSignature, system] : mSystems)
+        {
+            if ((entitySignature & systemSignature) == systemSignature)
+            {
+                system->mEntities.reserveAdditional(count);
+                for (size_t i = 0; i < count; ++i) { system->mEntities.insert(entities[i]); }
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i) { system->mEntities.erase(entities[i]); }
+            }
+        }
+    }
 
-    // Map from system type id to a system pointer.
-    std::unordered_map<size_t, std::shared_ptr<System>> mSystems;
-};
+protected:
+    /** @return The index of the system in mSystems. */
+    template<typename sys>
+    size_t validateSystem()
+    {
+        const ecs::systemId id = ecs::typeIndex<ecs::systemFamily, sys>;
+        if (id >= mSystemIndices.size() || mSystemIndices[id] == ecs::invalidId)
+        {
+            debug::log("System " + ecs::toString<sys>() + " has not been registered.", debug::severity::Fatal);
+        }
+        return mSystemIndices[id];
+    }
 
+    // System id to an index into mSystems.
+    std::vector<size_t> mSystemIndices;
 
+    std::vector<systemRecord> mSystems;
+};
@@ -0,0 +1,134 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief A work-stealing thread pool.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Lets a worker find its own queue when it submits or helps out with work.
+    thread_local const ThreadPool *currentPool { nullptr };
+    thread_local size_t currentWorkerIndex { 0 };
+}
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    // There is always at least one queue so that a pool without any workers can still take tasks.
+    const size_t queueCount = std::max<size_t>(threadCount, 1);
+    mQueues.reserve(queueCount);
+    for (size_t i = 0; i < queueCount; ++i) { mQueues.push_back(std::make_unique<taskQueue>()); }
+
+    mThreads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) { mThreads.emplace_back(&ThreadPool::workerLoop, this, i); }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mIsRunning = false;
+    }
+    mSleepCondition.notify_all();
+    for (auto &thread : mThreads) { thread.join(); }
+}
+
+size_t ThreadPool::defaultThreadCount()
+{
+    const size_t hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void ThreadPool::submit(ThreadPool::task job)
+{
+    const size_t queueIndex = currentPool == this
+            ? currentWorkerIndex
+            : mNextQueue.fetch_add(1, std::memory_order_relaxed) % mQueues.size();
+    {
+        // Counted before the push so that the count never drops below the number of queued tasks.
+        // Taking the lock stops a worker from missing the wakeup between checking for work and sleeping.
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mPendingCount.fetch_add(1, std::memory_order_release);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mQueues[queueIndex]->mutex);
+        mQueues[queueIndex]->tasks.push_back(std::move(job));
+    }
+    mSleepCondition.notify_one();
+}
+
+bool ThreadPool::tryRunPendingTask()
+{
+    if (mPendingCount.load(std::memory_order_acquire) == 0) { return false; }
+
+    task job;
+    const size_t queueIndex = currentQueue();
+    if (popTask(queueIndex, job) || stealTask(queueIndex, job))
+    {
+        job();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+    currentPool = this;
+    currentWorkerIndex = index;
+
+    while (true)
+    {
+        task job;
+        if (popTask(index, job) || stealTask(index, job))
+        {
+            job();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mSleepCondition.wait(lock, [this]() {
+            return !mIsRunning || mPendingCount.load(std::memory_order_acquire) > 0;
+        });
+        if (!mIsRunning) { return; }
+    }
+}
+
+bool ThreadPool::popTask(size_t queueIndex, ThreadPool::task &job)
+{
+    // The owner works from the back so the most recently submitted (and cache warm) task runs first.
+    auto &queue = *mQueues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) { return false; }
+
+    job = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    mPendingCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ThreadPool::stealTask(size_t thiefIndex, ThreadPool::task &job)
+{
+    // Thieves take from the front which holds the oldest, and typically largest, tasks.
+    for (size_t i = 1; i <= mQueues.size(); ++i)
+    {
+        auto &queue = *mQueues[(thiefIndex + i) % mQueues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) { continue; }
+
+        job = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        mPendingCount.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+size_t ThreadPool::currentQueue() const
+{
+    return currentPool == this ? currentWorkerIndex : 0;
+}
@@ -110,10 +110,10 @@ ModelData loadObj(std::string_view path)
     for (const auto &material : materials)
     {
         textures.push_back({ material.mapKd, material.mapNormal });
-        outMaterials.push_back({ material.ka, material.kd, 0, material.ks, material.ns });
+        outMaterials.push_back({ material.ka, material.kd, 0, material.ks, material.ns, 0, material.d });
     }
 
-    return { vertices, indices, outMaterials, textures };
+    return { { std::move(vertices), std::move(indices) }, std::move(outMaterials), std::move(textures) };
 }
 
 Vertex
@@ -0,0 +1,445 @@
+/**
+ * @file FrameGraph.cpp
+ * @brief Orders, culls and runs render passes and places their transient textures.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "FrameGraph.h"
+
+#include <glew.h>
+#include <algorithm>
+#include <sstream>
+
+FrameGraph::FrameGraph()
+{
+    mResources.push_back({ "Backbuffer", { }, 0, true, true });
+    mBackbuffer = { 0 };
+}
+
+FrameGraph::~FrameGraph()
+{
+    release();
+    for (const pooledTexture &texture : mPool) { glDeleteTextures(1, &texture.id); }
+}
+
+FrameGraph::resource FrameGraph::builder::read(resource target)
+{
+    if (!target.isValid() || target.id >= mGraph.mResources.size())
+    {
+        debug::log("Pass " + mGraph.mPasses[mPass].name + " reads a resource that does not exist.",
+                   debug::severity::Major);
+        return target;
+    }
+    mGraph.mPasses[mPass].reads.push_back(target.id);
+    return target;
+}
+
+FrameGraph::resource FrameGraph::builder::write(resource target)
+{
+    if (!target.isValid() || target.id >= mGraph.mResources.size())
+    {
+        debug::log("Pass " + mGraph.mPasses[mPass].name + " writes a resource that does not exist.",
+                   debug::severity::Major);
+        return target;
+    }
+    mGraph.mPasses[mPass].writes.push_back(target.id);
+    return target;
+}
+
+void FrameGraph::builder::setSideEffects()
+{
+    mGraph.mPasses[mPass].hasSideEffects = true;
+}
+
+unsigned int FrameGraph::context::getTexture(resource target) const
+{
+    return mGraph.mResources[target.id].id;
+}
+
+unsigned int FrameGraph::context::getBuffer(resource target) const
+{
+    return mGraph.mResources[target.id].id;
+}
+
+unsigned int FrameGraph::context::getFramebuffer() const
+{
+    return mGraph.mPasses[mPass].framebuffer;
+}
+
+glm::ivec2 FrameGraph::context::getSize() const
+{
+    return mGraph.mPasses[mPass].size;
+}
+
+void FrameGraph::setBackbuffer(unsigned int framebuffer, const glm::ivec2 &size)
+{
+    mResources[mBackbuffer.id].id = framebuffer;
+    setBackbufferSize(size);
+    mIsDirty = true;
+}
+
+void FrameGraph::setBackbufferSize(const glm::ivec2 &size)
+{
+    const glm::ivec2 clamped = glm::max(size, glm::ivec2(1));
+    if (clamped == mBackbufferSize) { return; }
+    mBackbufferSize = clamped;
+    mIsDirty = true;
+}
+
+FrameGraph::resource FrameGraph::createTexture(std::string name, const textureDesc &desc)
+{
+    mResources.push_back({ std::move(name), desc, 0, true, false });
+    mIsDirty = true;
+    return { static_cast<unsigned int>(mResources.size() - 1) };
+}
+
+FrameGraph::resource FrameGraph::importBuffer(std::string name, unsigned int id)
+{
+    mResources.push_back({ std::move(name), { }, id, false, true });
+    mIsDirty = true;
+    return { static_cast<unsigned int>(mResources.size() - 1) };
+}
+
+void FrameGraph::addPass(std::string name, const std::function<void(builder &)> &setup,
+                         std::function<void(const context &)> execute)
+{
+    passNode newPass;
+    newPass.name = std::move(name);
+    newPass.execute = std::move(execute);
+    mPasses.push_back(std::move(newPass));
+
+    builder passBuilder(*this, mPasses.size() - 1);
+    setup(passBuilder);
+    mIsDirty = true;
+}
+
+std::vector<size_t> FrameGraph::findDependencies(size_t pass) const
+{
+    const passNode &current = mPasses[pass];
+    const auto writes = [](const passNode &node, unsigned int id) {
+        return std::find(node.writes.begin(), node.writes.end(), id) != node.writes.end();
+    };
+
+    // Passes that only read something run after everything that writes it. Passes that read and write it, or
+    // only write it, run after the writers that were added before them.
+    std::vector<size_t> dependencies;
+    for (size_t other = 0; other < mPasses.size(); ++other)
+    {
+        if (other == pass) { continue; }
+        bool isDependency = false;
+        for (const unsigned int id : current.reads)
+        {
+            if (writes(mPasses[other], id) && (other < pass || !writes(current, id))) { isDependency = true; }
+        }
+        for (const unsigned int id : current.writes)
+        {
+            if (other < pass && writes(mPasses[other], id)) { isDependency = true; }
+        }
+        if (isDependency) { dependencies.push_back(other); }
+    }
+    return dependencies;
+}
+
+void FrameGraph::compile()
+{
+    release();
+
+    std::vector<std::vector<size_t>> dependencies(mPasses.size());
+    for (size_t i = 0; i < mPasses.size(); ++i) { dependencies[i] = findDependencies(i); }
+
+    // Anything that the backbuffer or a pass with side effects doesn't depend on is culled.
+    std::vector<size_t> stack;
+    for (size_t i = 0; i < mPasses.size(); ++i)
+    {
+        passNode &pass = mPasses[i];
+        const bool writesBackbuffer =
+            std::find(pass.writes.begin(), pass.writes.end(), mBackbuffer.id) != pass.writes.end();
+        pass.isCulled = !(pass.hasSideEffects || writesBackbuffer);
+        if (!pass.isCulled) { stack.push_back(i); }
+    }
+    while (!stack.empty())
+    {
+        const size_t pass = stack.back();
+        stack.pop_back();
+        for (const size_t dependency : dependencies[pass])
+        {
+            if (!mPasses[dependency].isCulled) { continue; }
+            mPasses[dependency].isCulled = false;
+            stack.push_back(dependency);
+        }
+    }
+
+    // Passes whose dependencies have all been placed are ready. The one added first goes next so that the order
+    // is deterministic.
+    std::vector<bool> isPlaced(mPasses.size(), false);
+    size_t aliveCount = 0;
+    for (const passNode &pass : mPasses) { aliveCount += pass.isCulled ? 0 : 1; }
+    while (mOrder.size() < aliveCount)
+    {
+        size_t next = mPasses.size();
+        for (size_t i = 0; i < mPasses.size() && next == mPasses.size(); ++i)
+        {
+            if (mPasses[i].isCulled || isPlaced[i]) { continue; }
+            const bool isReady = std::all_of(dependencies[i].begin(), dependencies[i].end(), [&](size_t dependency) {
+                return isPlaced[dependency];
+            });
+            if (isReady) { next = i; }
+        }
+
+        if (next == mPasses.size())
+        {
+            debug::log("The frame graph has a cycle. The remaining passes are run in the order they were added.",
+                       debug::severity::Major);
+            for (size_t i = 0; i < mPasses.size(); ++i)
+            {
+                if (!mPasses[i].isCulled && !isPlaced[i]) { mOrder.push_back(i); }
+            }
+            break;
+        }
+        isPlaced[next] = true;
+        mOrder.push_back(next);
+    }
+
+    // The first and last position in mOrder that each transient texture is used at.
+    constexpr size_t unused = std::numeric_limits<size_t>::max();
+    std::vector<size_t> firstUse(mResources.size(), unused);
+    std::vector<size_t> lastUse(mResources.size(), 0);
+    for (size_t position = 0; position < mOrder.size(); ++position)
+    {
+        const passNode &pass = mPasses[mOrder[position]];
+        for (const auto *ids : { &pass.reads, &pass.writes })
+        {
+            for (const unsigned int id : *ids)
+            {
+                firstUse[id] = std::min(firstUse[id], position);
+                lastUse[id] = std::max(lastUse[id], position);
+            }
+        }
+    }
+
+    // Textures are taken from the pool at their first use and given back after their last. Textures from the last
+    // compile are reused if they still match, so a recompile that doesn't resize anything creates nothing.
+    std::vector<pooledTexture> spare = std::move(mPool);
+    mPool.clear();
+    std::vector<bool> isInUse;
+    for (size_t position = 0; position < mOrder.size(); ++position)
+    {
+        for (size_t id = 0; id < mResources.size(); ++id)
+        {
+            resourceNode &texture = mResources[id];
+            if (!texture.isTexture || texture.isImported || firstUse[id] != position) { continue; }
+
+            size_t index = 0;
+            while (index < mPool.size() && (isInUse[index] || !(mPool[index].desc == texture.desc))) { ++index; }
+            if (index == mPool.size())
+            {
+                const glm::ivec2 size = getTextureSize(texture.desc);
+                const auto it = std::find_if(spare.begin(), spare.end(), [&](const pooledTexture &pooled) {
+                    return pooled.desc == texture.desc && pooled.size == size;
+                });
+                if (it != spare.end())
+                {
+                    mPool.push_back(*it);
+                    spare.erase(it);
+                }
+                else
+                {
+                    pooledTexture pooled { texture.desc, size, 0 };
+                    glCreateTextures(GL_TEXTURE_2D, 1, &pooled.id);
+                    glTextureStorage2D(pooled.id, 1, texture.desc.format, size.x, size.y);
+                    glTextureParameteri(pooled.id, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                    glTextureParameteri(pooled.id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                    glTextureParameteri(pooled.id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                    glTextureParameteri(pooled.id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                    mPool.push_back(pooled);
+                }
+                isInUse.push_back(false);
+            }
+            isInUse[index] = true;
+            texture.poolIndex = index;
+            texture.id = mPool[index].id;
+        }
+
+        for (size_t id = 0; id < mResources.size(); ++id)
+        {
+            const resourceNode &texture = mResources[id];
+            if (texture.isTexture && !texture.isImported && firstUse[id] != unused && lastUse[id] == position)
+            {
+                isInUse[texture.poolIndex] = false;
+            }
+        }
+    }
+    for (const pooledTexture &texture : spare) { glDeleteTextures(1, &texture.id); }
+
+    for (const size_t index : mOrder)
+    {
+        passNode &pass = mPasses[index];
+        glCreateQueries(GL_TIME_ELAPSED, static_cast<GLsizei>(queryLatency), pass.queries.data());
+
+        if (std::find(pass.writes.begin(), pass.writes.end(), mBackbuffer.id) != pass.writes.end())
+        {
+            pass.framebuffer = mResources[mBackbuffer.id].id;
+            pass.size = mBackbufferSize;
+            pass.bindsFramebuffer = true;
+            continue;
+        }
+
+        std::vector<GLenum> drawBuffers;
+        for (const unsigned int id : pass.writes)
+        {
+            const resourceNode &texture = mResources[id];
+            if (!texture.isTexture) { continue; }
+            if (!pass.bindsFramebuffer)
+            {
+                glCreateFramebuffers(1, &pass.framebuffer);
+                pass.ownsFramebuffer = true;
+                pass.size = getTextureSize(texture.desc);
+                pass.bindsFramebuffer = true;
+            }
+
+            if (isDepthFormat(texture.desc.format))
+            {
+                glNamedFramebufferTexture(pass.framebuffer, GL_DEPTH_ATTACHMENT, texture.id, 0);
+            }
+            else
+            {
+                const GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(drawBuffers.size());
+                glNamedFramebufferTexture(pass.framebuffer, attachment, texture.id, 0);
+                drawBuffers.push_back(attachment);
+            }
+        }
+        if (!pass.bindsFramebuffer) { continue; }
+
+        if (drawBuffers.empty()) { glNamedFramebufferDrawBuffer(pass.framebuffer, GL_NONE); }
+        else
+        {
+            glNamedFramebufferDrawBuffers(pass.framebuffer, static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+        }
+        if (glCheckNamedFramebufferStatus(pass.framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            debug::log("The framebuffer for pass " + pass.name + " is not complete.", debug::severity::Major);
+        }
+    }
+
+    mIsDirty = false;
+    debug::log(describe(), debug::severity::Notification);
+}
+
+void FrameGraph::release()
+{
+    for (passNode &pass : mPasses)
+    {
+        if (pass.queries[0] != 0) { glDeleteQueries(static_cast<GLsizei>(queryLatency), pass.queries.data()); }
+        if (pass.ownsFramebuffer) { glDeleteFramebuffers(1, &pass.framebuffer); }
+        pass.queries = { };
+        pass.isQueryPending = { };
+        pass.framebuffer = 0;
+        pass.bindsFramebuffer = false;
+        pass.ownsFramebuffer = false;
+        pass.size = glm::ivec2(0);
+    }
+    mOrder.clear();
+}
+
+void FrameGraph::execute()
+{
+    if (mIsDirty) { compile(); }
+
+    const size_t slot = mFrame % queryLatency;
+    for (const size_t index : mOrder)
+    {
+        passNode &pass = mPasses[index];
+
+        // The query in this slot was issued queryLatency frames ago, so it has usually finished by now.
+        const unsigned int query = pass.queries[slot];
+        if (pass.isQueryPending[slot])
+        {
+            GLint isAvailable = GL_FALSE;
+            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+            if (isAvailable == GL_TRUE)
+            {
+                GLuint64 nanoseconds = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+                pass.milliseconds = static_cast<double>(nanoseconds) / 1'000'000.0;
+            }
+        }
+
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        if (pass.bindsFramebuffer)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
+            glViewport(0, 0, pass.size.x, pass.size.y);
+        }
+        if (pass.execute) { pass.execute(context(*this, index)); }
+        glEndQuery(GL_TIME_ELAPSED);
+        pass.isQueryPending[slot] = true;
+    }
+    ++mFrame;
+
+    // Anything drawn after the graph, such as ImGui, goes to the backbuffer.
+    glBindFramebuffer(GL_FRAMEBUFFER, mResources[mBackbuffer.id].id);
+    glViewport(0, 0, mBackbufferSize.x, mBackbufferSize.y);
+}
+
+std::vector<FrameGraph::passTiming> FrameGraph::getTimings() const
+{
+    std::vector<passTiming> timings;
+    timings.reserve(mPasses.size());
+    for (const size_t index : mOrder) { timings.push_back({ mPasses[index].name, mPasses[index].milliseconds, false }); }
+    for (const passNode &pass : mPasses)
+    {
+        if (pass.isCulled) { timings.push_back({ pass.name, 0.0, true }); }
+    }
+    return timings;
+}
+
+size_t FrameGraph::getTransientTextureCount() const
+{
+    return std::count_if(mResources.begin(), mResources.end(), [](const resourceNode &resource) {
+        return resource.isTexture && !resource.isImported;
+    });
+}
+
+glm::ivec2 FrameGraph::getTextureSize(const textureDesc &desc) const
+{
+    return glm::max(glm::ivec2(glm::vec2(mBackbufferSize) * desc.scale + 0.5f), glm::ivec2(1));
+}
+
+bool FrameGraph::isDepthFormat(unsigned int format)
+{
+    switch (format)
+    {
+        case GL_DEPTH_COMPONENT16:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32:
+        case GL_DEPTH_COMPONENT32F:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::string FrameGraph::describe() const
+{
+    std::ostringstream stream;
+    stream << "Frame graph (" << mPool.size() << " pooled textures for " << getTransientTextureCount()
+           << " transient):";
+    for (const size_t index : mOrder)
+    {
+        const passNode &pass = mPasses[index];
+        stream << "\n    " << pass.name;
+        for (const unsigned int id : pass.writes)
+        {
+            const resourceNode &written = mResources[id];
+            stream << "\n        writes " << written.name;
+            if (written.isTexture && !written.isImported) { stream << " (pooled texture " << written.poolIndex << ")"; }
+        }
+    }
+    for (const passNode &pass : mPasses)
+    {
+        if (pass.isCulled) { stream << "\n    " << pass.name << " (culled)"; }
+    }
+    return stream.str();
+}
@@ -0,0 +1,117 @@
+/**
+ * @file FreeListAllocator.cpp
+ * @brief Hands out ranges of a fixed size pool.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "FreeListAllocator.h"
+#include "DebugLogger.h"
+
+FreeListAllocator::FreeListAllocator(size_t capacity)
+{
+    reset(capacity);
+}
+
+size_t FreeListAllocator::allocate(size_t size)
+{
+    if (size == 0) { return invalidOffset; }
+
+    const auto fit = mFreeBySize.lower_bound(size);
+    if (fit == mFreeBySize.end()) { return invalidOffset; }
+
+    const size_t offset = fit->second;
+    const size_t freeSize = fit->first;
+    removeFreeRange(mFreeByOffset.find(offset));
+    if (freeSize > size) { addFreeRange(offset + size, freeSize - size); }
+
+    mUsed += size;
+    return offset;
+}
+
+void FreeListAllocator::free(size_t offset, size_t size)
+{
+    if (size == 0) { return; }
+    if (offset + size > mCapacity || size > mUsed)
+    {
+        debug::log("Freed a range that was never allocated.", debug::severity::Major);
+        return;
+    }
+    mUsed -= size;
+
+    // Merge with the free ranges either side.
+    auto next = mFreeByOffset.lower_bound(offset);
+    if (next != mFreeByOffset.end() && next->first == offset + size)
+    {
+        size += next->second;
+        removeFreeRange(next);
+    }
+
+    auto previous = mFreeByOffset.lower_bound(offset);
+    if (previous != mFreeByOffset.begin())
+    {
+        --previous;
+        if (previous->first + previous->second == offset)
+        {
+            offset = previous->first;
+            size += previous->second;
+            removeFreeRange(previous);
+        }
+    }
+
+    addFreeRange(offset, size);
+}
+
+void FreeListAllocator::grow(size_t newCapacity)
+{
+    if (newCapacity <= mCapacity) { return; }
+    const size_t oldCapacity = mCapacity;
+    const size_t added = newCapacity - oldCapacity;
+
+    // Pretend the new space was allocated and then free it so that it merges with a free range at the end.
+    mCapacity = newCapacity;
+    mUsed += added;
+    free(oldCapacity, added);
+}
+
+void FreeListAllocator::reset(size_t capacity, size_t used)
+{
+    mFreeByOffset.clear();
+    mFreeBySize.clear();
+    mCapacity = capacity;
+    mUsed = used;
+    if (capacity > used) { addFreeRange(used, capacity - used); }
+}
+
+size_t FreeListAllocator::largestFreeRange() const
+{
+    return mFreeBySize.empty() ? 0 : mFreeBySize.rbegin()->first;
+}
+
+float FreeListAllocator::fragmentation() const
+{
+    const size_t freeSpace = mCapacity - mUsed;
+    if (freeSpace == 0) { return 0.f; }
+    return 1.f - static_cast<float>(largestFreeRange()) / static_cast<float>(freeSpace);
+}
+
+void FreeListAllocator::addFreeRange(size_t offset, size_t size)
+{
+    mFreeByOffset.emplace(offset, size);
+    mFreeBySize.emplace(size, offset);
+}
+
+void FreeListAllocator::removeFreeRange(std::map<size_t, size_t>::iterator it)
+{
+    const auto [first, last] = mFreeBySize.equal_range(it->second);
+    for (auto sizeIt = first; sizeIt != last; ++sizeIt)
+    {
+        if (sizeIt->second == it->first)
+        {
+            mFreeBySize.erase(sizeIt);
+            break;
+        }
+    }
+    mFreeByOffset.erase(it);
+}
@@ -0,0 +1,131 @@
+/**
+ * @file FrustumCuller.cpp
+ * @brief Tests batches of bounding spheres against the camera's frustum.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "FrustumCuller.h"
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+#if defined(__AVX__)
+    #define FRUSTUM_CULLER_AVX
+    #include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define FRUSTUM_CULLER_SSE
+    #include <xmmintrin.h>
+#endif
+
+#if defined(FRUSTUM_CULLER_AVX)
+    const size_t FrustumCuller::batchSize = 8;
+#elif defined(FRUSTUM_CULLER_SSE)
+    const size_t FrustumCuller::batchSize = 4;
+#else
+    const size_t FrustumCuller::batchSize = 1;
+#endif
+
+std::array<glm::vec4, 6> FrustumCuller::extractPlanes(const glm::mat4 &vpMatrix)
+{
+    // Each plane is the last row of the matrix plus or minus one of the others. glm is column major.
+    const glm::mat4 rows = glm::transpose(vpMatrix);
+    std::array<glm::vec4, 6> planes {
+        rows[3] + rows[0],
+        rows[3] - rows[0],
+        rows[3] + rows[1],
+        rows[3] - rows[1],
+        rows[3] + rows[2],
+        rows[3] - rows[2]
+    };
+
+    for (glm::vec4 &plane : planes) { plane /= glm::length(glm::vec3(plane)); }
+    return planes;
+}
+
+void FrustumCuller::setFrustum(const glm::mat4 &vpMatrix)
+{
+    mPlanes = extractPlanes(vpMatrix);
+}
+
+void FrustumCuller::clear()
+{
+    mX.clear();
+    mY.clear();
+    mZ.clear();
+    mRadius.clear();
+    mCount = 0;
+}
+
+void FrustumCuller::add(const glm::vec3 &centre, float radius)
+{
+    mX.push_back(centre.x);
+    mY.push_back(centre.y);
+    mZ.push_back(centre.z);
+    mRadius.push_back(radius);
+    ++mCount;
+}
+
+const std::vector<unsigned int> &FrustumCuller::cull()
+{
+    mVisible.clear();
+
+    // Padding spheres have a negative infinite radius, so they are outside of every plane.
+    const size_t paddedCount = (mCount + batchSize - 1) / batchSize * batchSize;
+    mX.resize(paddedCount, 0.f);
+    mY.resize(paddedCount, 0.f);
+    mZ.resize(paddedCount, 0.f);
+    mRadius.resize(paddedCount, -std::numeric_limits<float>::infinity());
+
+    for (size_t first = 0; first < paddedCount; first += batchSize)
+    {
+        // Bit i is set if sphere first + i is inside of every plane checked so far.
+#if defined(FRUSTUM_CULLER_AVX)
+        const __m256 x = _mm256_loadu_ps(&mX[first]);
+        const __m256 y = _mm256_loadu_ps(&mY[first]);
+        const __m256 z = _mm256_loadu_ps(&mZ[first]);
+        const __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&mRadius[first]));
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const glm::vec4 &plane : mPlanes)
+        {
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(plane.x)), _mm256_set1_ps(plane.w));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(y, _mm256_set1_ps(plane.y)));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(z, _mm256_set1_ps(plane.z)));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+        }
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+#elif defined(FRUSTUM_CULLER_SSE)
+        const __m128 x = _mm_loadu_ps(&mX[first]);
+        const __m128 y = _mm_loadu_ps(&mY[first]);
+        const __m128 z = _mm_loadu_ps(&mZ[first]);
+        const __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&mRadius[first]));
+        __m128 inside = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+        for (const glm::vec4 &plane : mPlanes)
+        {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_set1_ps(plane.w));
+            distance = _mm_add_ps(distance, _mm_mul_ps(y, _mm_set1_ps(plane.y)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(plane.z)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+        }
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(inside));
+#else
+        uint32_t mask = 1;
+        for (const glm::vec4 &plane : mPlanes)
+        {
+            const float distance = plane.x * mX[first] + plane.y * mY[first] + plane.z * mZ[first] + plane.w;
+            if (distance < -mRadius[first]) { mask = 0; }
+        }
+#endif
+        while (mask != 0)
+        {
+            mVisible.push_back(static_cast<unsigned int>(first) + std::countr_zero(mask));
+            mask &= mask - 1;
+        }
+    }
+
+    mTestedCount = mCount;
+    mCulledCount = mCount - mVisible.size();
+    return mVisible;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file MaterialPool.cpp
+ * @brief Every material in one shader storage buffer, re-uploaded a range at a time.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "MaterialPool.h"
+#include "DebugLogger.h"
+
+#include <glew.h>
+#include <algorithm>
+
+MaterialPool::MaterialPool()
+{
+    glCreateBuffers(1, &mId);
+}
+
+MaterialPool::~MaterialPool()
+{
+    glDeleteBuffers(1, &mId);
+}
+
+unsigned int MaterialPool::add(const Material &material)
+{
+    return add(std::span<const Material>(&material, 1));
+}
+
+unsigned int MaterialPool::add(std::span<const Material> materials)
+{
+    const size_t first = mMaterials.size();
+    for (const Material &material : materials) { mMaterials.push_back(toGpu(material)); }
+    markDirty(first, mMaterials.size());
+    return static_cast<unsigned int>(first);
+}
+
+void MaterialPool::set(unsigned int id, const Material &material)
+{
+    if (id >= mMaterials.size())
+    {
+        debug::log("Material " + std::to_string(id) + " is not in the pool.", debug::severity::Warning);
+        return;
+    }
+    mMaterials[id] = toGpu(material);
+    markDirty(id, id + 1);
+}
+
+void MaterialPool::upload()
+{
+    mLastUploadBytes = 0;
+    if (mDirtyFirst >= mDirtyLast) { return; }
+
+    // New storage has nothing in it, so everything is sent again.
+    if (mMaterials.size() > mCapacity)
+    {
+        mCapacity = std::max(mMaterials.size(), mCapacity * 2);
+        glNamedBufferData(mId, static_cast<GLsizeiptr>(mCapacity * sizeof(gpuMaterial)), nullptr, GL_DYNAMIC_DRAW);
+        mDirtyFirst = 0;
+        mDirtyLast = mMaterials.size();
+    }
+
+    mLastUploadBytes = (mDirtyLast - mDirtyFirst) * sizeof(gpuMaterial);
+    glNamedBufferSubData(mId, static_cast<GLintptr>(mDirtyFirst * sizeof(gpuMaterial)),
+                         static_cast<GLsizeiptr>(mLastUploadBytes), &mMaterials[mDirtyFirst]);
+    mDirtyFirst = 0;
+    mDirtyLast = 0;
+}
+
+void MaterialPool::bindBase(unsigned int index) const
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, mId);
+}
+
+MaterialPool::gpuMaterial MaterialPool::toGpu(const Material &material)
+{
+    return {
+        glm::vec4(material.kAmbient, 1.f),
+        glm::vec4(material.kDiffuse, 1.f),
+        glm::vec4(material.kSpecular, 1.f),
+        material.nSpecular,
+        material.dissolve
+    };
+}
+
+void MaterialPool::markDirty(size_t first, size_t last)
+{
+    if (mDirtyFirst >= mDirtyLast)
+    {
+        mDirtyFirst = first;
+        mDirtyLast = last;
+        return;
+    }
+    mDirtyFirst = std::min(mDirtyFirst, first);
+    mDirtyLast = std::max(mDirtyLast, last);
+}
@@ -8,6 +8,8 @@
 
 #include "MaterialProcessor.h"
 #include <glew.h>
+#include <algorithm>
+#include <numeric>
 
 
 MaterialProcessor::MaterialProcessor()
@@ -18,11 +20,9 @@ MaterialProcessor::MaterialProcessor()
 
 void MaterialProcessor::init()
 {
-    for (const auto &entity : mEntities)
+    for (auto [mats, textureMats, renderUniforms] :
+            view<std::vector<Material>, const std::vector<MaterialTexture>, RendererUniforms>())
     {
-        auto &mats = getComponent<std::vector<Material>>(entity);
-        auto &textureMats = getComponent<std::vector<MaterialTexture>>(entity);
-
         std::vector<std::string> kDPaths;
         std::vector<std::string> normalsMapPaths;
 
@@ -38,19 +38,19 @@ void MaterialProcessor::init()
         unsigned int kDiffusesId = TextureSystem::createTextureArray(kDPaths, TextureSystem::Diffuse);
         unsigned int normalMapsId = TextureSystem::createTextureArray(normalsMapPaths, TextureSystem::Diffuse);
 
-        std::vector<unsigned int> ids;
-        ids.reserve(mats.size());
-
         for (int i = 0; i < mats.size(); i++)
         {
             mats[i].kDTextureIndex = i;
             mats[i].normalMapIndex = i;
-            ids.emplace_back(addMaterial(mats[i]));
         }
 
+        // The shader finds an entity's materials by offsetting from the first, so they must be next to each other.
+        const unsigned int firstId = mMaterialPool.add(std::span<const Material>(mats));
+        std::vector<unsigned int> ids(mats.size());
+        std::iota(ids.begin(), ids.end(), firstId);
+
 //        if (ids.empty()) { ids = { mDefaultId }; }
 
-        auto &renderUniforms = getComponent<RendererUniforms>(entity);
         renderUniforms.materialIds = std::move(ids);
         renderUniforms.diffuseTexturesId = kDiffusesId;
         renderUniforms.normalMapId = normalMapsId;
@@ -68,8 +68,7 @@ void MaterialProcessor::createDefaultMaterial()
 
 unsigned int MaterialProcessor::addMaterial(const Material &material)
 {
-    mMaterials.insert({ mNextId, material });
-    return mNextId++;
+    return mMaterialPool.add(material);
 }
 
 void MaterialProcessor::bind() const
@@ -84,39 +83,37 @@ void MaterialProcessor::unbind()
     Shader::unBind();
 }
 
-void MaterialProcessor::setupMaterials(const std::vector<unsigned int> &materialIds, unsigned int diffuseTextureIds,
-                                       unsigned int normalMapIds)
+void MaterialProcessor::bindTextures(unsigned int diffuseTextureIds, unsigned int normalMapIds) const
 {
-    glActiveTexture(GL_TEXTURE0);
-    if (diffuseTextureIds == 0) { glBindTexture(GL_TEXTURE_2D_ARRAY, mDefaultKDiffuseTextureId); }
-    else { glBindTexture(GL_TEXTURE_2D_ARRAY, diffuseTextureIds); }
-    mShader.setUniform("u_diffuse_map_textures", 0);
-
-    glActiveTexture(GL_TEXTURE0 + 1);
-    if (normalMapIds == 0) { glBindTexture(GL_TEXTURE_2D_ARRAY, mDefaultNormalTextureId); }
-    else { glBindTexture(GL_TEXTURE_2D_ARRAY, normalMapIds); }
-    mShader.setUniform("u_normal_map_textures", 1);
-
-    auto i = 0;
-    for (const auto &id : materialIds)
-    {
-        // Find the material.
-        auto material = mMaterials.at(id);
-        // Set the uniforms based on that material.
-        std::string stringI = std::to_string(i);
-        mShader.setUniform("u_materials[" + stringI + "].k_ambient", glm::vec4(material.kAmbient, 1.f));
-        mShader.setUniform("u_materials[" + stringI + "].k_diffuse", glm::vec4(material.kDiffuse, 1.f));
-        mShader.setUniform("u_materials[" + stringI + "].k_specular", glm::vec4(material.kSpecular, 1.f));
-        mShader.setUniform("u_materials[" + stringI + "].n_specular", material.nSpecular);
-        i++;
-    }
-    if (materialIds.empty())
+    glBindTextureUnit(0, diffuseTextureIds == 0 ? mDefaultKDiffuseTextureId : diffuseTextureIds);
+    glBindTextureUnit(1, normalMapIds == 0 ? mDefaultNormalTextureId : normalMapIds);
+}
+
+void MaterialProcessor::updateMaterials()
+{
+    beginRun();
+    for (const auto &[mats, renderUniforms] :
+            view<const std::vector<Material>, const RendererUniforms>().changed<std::vector<Material>>())
     {
-        // Bind the default Texture.
-        auto defaultMat = mMaterials[mDefaultId];
-        mShader.setUniform("u_materials[0].k_ambient", glm::vec4(defaultMat.kAmbient, 1.f));
-        mShader.setUniform("u_materials[0].k_diffuse", glm::vec4(defaultMat.kDiffuse, 1.f));
-        mShader.setUniform("u_materials[0].k_specular", glm::vec4(defaultMat.kSpecular, 1.f));
-        mShader.setUniform("u_materials[0].n_specular", defaultMat.nSpecular);
+        const size_t count = std::min(mats.size(), renderUniforms.materialIds.size());
+        for (size_t i = 0; i < count; ++i) { mMaterialPool.set(renderUniforms.materialIds[i], mats[i]); }
     }
 }
+
+void MaterialProcessor::uploadMaterials()
+{
+    mMaterialPool.upload();
+    mMaterialPool.bindBase(1);
+}
+
+bool MaterialProcessor::isTransparent(const std::vector<unsigned int> &materialIds) const
+{
+    return std::any_of(materialIds.begin(), materialIds.end(), [this](unsigned int id) {
+        return mMaterialPool.isTransparent(id);
+    });
+}
+
+unsigned int MaterialProcessor::getMaterialOffset(const std::vector<unsigned int> &materialIds) const
+{
+    return materialIds.empty() ? mDefaultId : materialIds.front();
+}
@@ -0,0 +1,184 @@
+/**
+ * @file MeshArena.cpp
+ * @brief Keeps every mesh on the GPU in a pair of large buffers.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "MeshArena.h"
+#include "Vertex.h"
+
+#include <glew.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+
+MeshArena::MeshArena(size_t vertexCapacity, size_t indexCapacity)
+{
+    glCreateVertexArrays(1, &mVertexArrayId);
+
+    // Every attribute reads from binding 0, which is pointed at the vertex buffer whenever it is replaced.
+    glEnableVertexArrayAttrib(mVertexArrayId, 0);  // Position
+    glEnableVertexArrayAttrib(mVertexArrayId, 1);  // UV Coord
+    glEnableVertexArrayAttrib(mVertexArrayId, 2);  // Normal
+    glEnableVertexArrayAttrib(mVertexArrayId, 3);  // Tangent
+    glEnableVertexArrayAttrib(mVertexArrayId, 4);  // BiTangent
+    glEnableVertexArrayAttrib(mVertexArrayId, 5);  // Texture Id
+
+    glVertexArrayAttribFormat(mVertexArrayId, 0, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, position));
+    glVertexArrayAttribFormat(mVertexArrayId, 1, 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, uvCoord));
+    glVertexArrayAttribFormat(mVertexArrayId, 2, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, normal));
+    glVertexArrayAttribFormat(mVertexArrayId, 3, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, tangent));
+    glVertexArrayAttribFormat(mVertexArrayId, 4, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, biTangent));
+    glVertexArrayAttribIFormat(mVertexArrayId, 5, 1, GL_INT, offsetof(Vertex, textureId));
+
+    for (unsigned int attribute = 0; attribute <= 5; ++attribute)
+    {
+        glVertexArrayAttribBinding(mVertexArrayId, attribute, 0);
+    }
+
+    reallocate(vertexCapacity, indexCapacity);
+}
+
+MeshArena::~MeshArena()
+{
+    glDeleteBuffers(1, &mVertexBufferId);
+    glDeleteBuffers(1, &mIndexBufferId);
+    glDeleteVertexArrays(1, &mVertexArrayId);
+}
+
+void MeshArena::add(MeshHandle handle, const PolygonalMesh &mesh)
+{
+    // allocate(0) has no offset to give back, which would look like the buffers are full.
+    if (mesh.vertices.empty() || mesh.indices.empty())
+    {
+        debug::log("Mesh " + std::to_string(handle.id) + " is empty so was not added to the arena.",
+                   debug::severity::Warning);
+        return;
+    }
+
+    if (handle.id >= mRanges.size()) { mRanges.resize(handle.id + 1); }
+    if (mRanges[handle.id].isValid())
+    {
+        debug::log("Mesh " + std::to_string(handle.id) + " is already in the arena.", debug::severity::Warning);
+        return;
+    }
+
+    size_t vertexOffset = mVertexAllocator.allocate(mesh.vertices.size());
+    size_t indexOffset = mIndexAllocator.allocate(mesh.indices.size());
+    if (vertexOffset == FreeListAllocator::invalidOffset || indexOffset == FreeListAllocator::invalidOffset)
+    {
+        if (vertexOffset != FreeListAllocator::invalidOffset) { mVertexAllocator.free(vertexOffset, mesh.vertices.size()); }
+        if (indexOffset != FreeListAllocator::invalidOffset) { mIndexAllocator.free(indexOffset, mesh.indices.size()); }
+
+        // Doubling keeps the number of moves small when lots of meshes are added in a row.
+        reallocate(std::max(mVertexAllocator.capacity() * 2, mVertexAllocator.used() + mesh.vertices.size()),
+                   std::max(mIndexAllocator.capacity() * 2, mIndexAllocator.used() + mesh.indices.size()));
+        vertexOffset = mVertexAllocator.allocate(mesh.vertices.size());
+        indexOffset = mIndexAllocator.allocate(mesh.indices.size());
+    }
+
+    const size_t vertexBytes = mesh.vertices.size() * sizeof(Vertex);
+    const size_t indexBytes = mesh.indices.size() * sizeof(unsigned int);
+    glNamedBufferSubData(mVertexBufferId, static_cast<GLintptr>(vertexOffset * sizeof(Vertex)),
+                         static_cast<GLsizeiptr>(vertexBytes), mesh.vertices.data());
+    glNamedBufferSubData(mIndexBufferId, static_cast<GLintptr>(indexOffset * sizeof(unsigned int)),
+                         static_cast<GLsizeiptr>(indexBytes), mesh.indices.data());
+    mUploadedBytes += vertexBytes + indexBytes;
+
+    mRanges[handle.id] = {
+        static_cast<int>(vertexOffset),
+        static_cast<unsigned int>(indexOffset),
+        static_cast<unsigned int>(mesh.indices.size()),
+        static_cast<unsigned int>(mesh.vertices.size())
+    };
+}
+
+void MeshArena::remove(MeshHandle handle)
+{
+    if (handle.id >= mRanges.size() || !mRanges[handle.id].isValid()) { return; }
+
+    drawRange &range = mRanges[handle.id];
+    mVertexAllocator.free(range.baseVertex, range.vertexCount);
+    mIndexAllocator.free(range.firstIndex, range.indexCount);
+    range = drawRange();
+}
+
+const MeshArena::drawRange &MeshArena::get(MeshHandle handle) const
+{
+    if (handle.id >= mRanges.size() || !mRanges[handle.id].isValid())
+    {
+        debug::log("Mesh " + std::to_string(handle.id) + " is not in the arena.", debug::severity::Fatal);
+    }
+    return mRanges[handle.id];
+}
+
+void MeshArena::defragment()
+{
+    reallocate(mVertexAllocator.capacity(), mIndexAllocator.capacity());
+}
+
+void MeshArena::bind() const
+{
+    glBindVertexArray(mVertexArrayId);
+}
+
+size_t MeshArena::takeUploadedBytes()
+{
+    return std::exchange(mUploadedBytes, 0);
+}
+
+float MeshArena::fragmentation() const
+{
+    return std::max(mVertexAllocator.fragmentation(), mIndexAllocator.fragmentation());
+}
+
+void MeshArena::reallocate(size_t vertexCapacity, size_t indexCapacity)
+{
+    // Buffers can't be empty.
+    vertexCapacity = std::max<size_t>(vertexCapacity, 1);
+    indexCapacity = std::max<size_t>(indexCapacity, 1);
+
+    unsigned int vertexBufferId { 0 };
+    unsigned int indexBufferId { 0 };
+    glCreateBuffers(1, &vertexBufferId);
+    glCreateBuffers(1, &indexBufferId);
+
+    // Storage can't be resized but can still be written to, which is all that adding a mesh needs.
+    glNamedBufferStorage(vertexBufferId, static_cast<GLsizeiptr>(vertexCapacity * sizeof(Vertex)), nullptr,
+                         GL_DYNAMIC_STORAGE_BIT);
+    glNamedBufferStorage(indexBufferId, static_cast<GLsizeiptr>(indexCapacity * sizeof(unsigned int)), nullptr,
+                         GL_DYNAMIC_STORAGE_BIT);
+
+    // Copies stay on the GPU so they don't count towards uploaded bytes.
+    size_t vertexEnd = 0;
+    size_t indexEnd = 0;
+    for (drawRange &range : mRanges)
+    {
+        if (!range.isValid()) { continue; }
+
+        glCopyNamedBufferSubData(mVertexBufferId, vertexBufferId,
+                                 static_cast<GLintptr>(range.baseVertex * sizeof(Vertex)),
+                                 static_cast<GLintptr>(vertexEnd * sizeof(Vertex)),
+                                 static_cast<GLsizeiptr>(range.vertexCount * sizeof(Vertex)));
+        glCopyNamedBufferSubData(mIndexBufferId, indexBufferId,
+                                 static_cast<GLintptr>(range.firstIndex * sizeof(unsigned int)),
+                                 static_cast<GLintptr>(indexEnd * sizeof(unsigned int)),
+                                 static_cast<GLsizeiptr>(range.indexCount * sizeof(unsigned int)));
+        range.baseVertex = static_cast<int>(vertexEnd);
+        range.firstIndex = static_cast<unsigned int>(indexEnd);
+        vertexEnd += range.vertexCount;
+        indexEnd += range.indexCount;
+    }
+
+    glDeleteBuffers(1, &mVertexBufferId);
+    glDeleteBuffers(1, &mIndexBufferId);
+    mVertexBufferId = vertexBufferId;
+    mIndexBufferId = indexBufferId;
+    mVertexAllocator.reset(vertexCapacity, vertexEnd);
+    mIndexAllocator.reset(indexCapacity, indexEnd);
+
+    glVertexArrayVertexBuffer(mVertexArrayId, 0, mVertexBufferId, 0, sizeof(Vertex));
+    glVertexArrayElementBuffer(mVertexArrayId, mIndexBufferId);
+}
@@ -0,0 +1,151 @@
+/**
+ * @file MeshRegistry.cpp
+ * @brief Owns mesh geometry and hands out handles to it.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "MeshRegistry.h"
+#include "Loader.h"
+
+#include <cmath>
+#include <cstring>
+
+static_assert(sizeof(Vertex) == 14 * sizeof(float) + sizeof(int), "Vertex must not have padding to be hashed as bytes.");
+
+MeshHandle MeshRegistry::add(PolygonalMesh &&mesh, std::string_view source)
+{
+    // The arena skips empty meshes, so a handle to one could never be drawn.
+    if (mesh.vertices.empty() || mesh.indices.empty()) { return {}; }
+
+    const size_t hash = hashContent(mesh);
+    const auto [first, last] = mContentHandles.equal_range(hash);
+    for (auto it = first; it != last; ++it)
+    {
+        // Hashes can collide, so the geometry itself has to match.
+        if (isContentEqual(mMeshes[it->second.id], mesh))
+        {
+            // The same geometry can come from more than one source. Each of them finds this mesh.
+            if (!source.empty())
+            {
+                mSourceHandles.try_emplace(std::string(source), it->second);
+                if (mSources[it->second.id].empty()) { mSources[it->second.id] = source; }
+            }
+            return it->second;
+        }
+    }
+
+    const MeshHandle handle { static_cast<unsigned int>(mMeshes.size()) };
+    mArena.add(handle, mesh);
+    mBounds.push_back(computeBounds(mesh));
+    mSources.emplace_back(source);
+    if (!source.empty()) { mSourceHandles.try_emplace(std::string(source), handle); }
+    if (mKeepCpuCopies)
+    {
+        mMeshes.push_back(std::move(mesh));
+        mContentHandles.emplace(hash, handle);
+    }
+    else
+    {
+        mMeshes.emplace_back();
+    }
+    return handle;
+}
+
+void MeshRegistry::remove(MeshHandle handle)
+{
+    if (handle.id >= mMeshes.size()) { return; }
+
+    mArena.remove(handle);
+    mMeshes[handle.id] = PolygonalMesh();
+    mSources[handle.id].clear();
+    std::erase_if(mSourceHandles, [handle](const auto &pair) { return pair.second == handle; });
+    std::erase_if(mContentHandles, [handle](const auto &pair) { return pair.second == handle; });
+    std::erase_if(mModels, [handle](const auto &pair) { return pair.second.mesh == handle; });
+}
+
+const RegisteredModel &MeshRegistry::load(std::string_view path)
+{
+    auto it = mModels.find(std::string(path));
+    if (it != mModels.end()) { return it->second; }
+
+    // Failed loads are remembered too so that the file isn't parsed again.
+    auto [mesh, materials, matTextures] = loadModel(path);
+    RegisteredModel model { add(std::move(mesh), path), std::move(materials), std::move(matTextures) };
+    return mModels.emplace(std::string(path), std::move(model)).first->second;
+}
+
+const PolygonalMesh &MeshRegistry::get(MeshHandle handle) const
+{
+    if (handle.id >= mMeshes.size())
+    {
+        debug::log("Mesh handle " + std::to_string(handle.id) + " does not exist.", debug::severity::Fatal);
+    }
+    return mMeshes[handle.id];
+}
+
+const Bounds &MeshRegistry::getBounds(MeshHandle handle) const
+{
+    if (handle.id >= mBounds.size())
+    {
+        debug::log("Mesh handle " + std::to_string(handle.id) + " does not exist.", debug::severity::Fatal);
+    }
+    return mBounds[handle.id];
+}
+
+const std::string &MeshRegistry::getSource(MeshHandle handle) const
+{
+    if (handle.id >= mSources.size())
+    {
+        debug::log("Mesh handle " + std::to_string(handle.id) + " does not exist.", debug::severity::Fatal);
+    }
+    return mSources[handle.id];
+}
+
+MeshHandle MeshRegistry::find(std::string_view source) const
+{
+    const auto it = mSourceHandles.find(std::string(source));
+    return it == mSourceHandles.end() ? MeshHandle() : it->second;
+}
+
+Bounds MeshRegistry::computeBounds(const PolygonalMesh &mesh)
+{
+    Bounds bounds { mesh.vertices[0].position, mesh.vertices[0].position };
+    for (const Vertex &vertex : mesh.vertices)
+    {
+        bounds.min = glm::min(bounds.min, vertex.position);
+        bounds.max = glm::max(bounds.max, vertex.position);
+    }
+
+    // Centring the sphere on the box and then fitting it to the vertices is tighter than the box's half diagonal.
+    bounds.centre = (bounds.min + bounds.max) * 0.5f;
+    float radiusSquared = 0.f;
+    for (const Vertex &vertex : mesh.vertices)
+    {
+        const glm::vec3 offset = vertex.position - bounds.centre;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+    bounds.radius = std::sqrt(radiusSquared);
+    return bounds;
+}
+
+size_t MeshRegistry::hashContent(const PolygonalMesh &mesh)
+{
+    // Vertex has no padding, so hashing the raw bytes is the same as hashing every member.
+    const std::string_view vertexBytes(reinterpret_cast<const char *>(mesh.vertices.data()),
+                                       mesh.vertices.size() * sizeof(Vertex));
+    const std::string_view indexBytes(reinterpret_cast<const char *>(mesh.indices.data()),
+                                      mesh.indices.size() * sizeof(unsigned int));
+    const size_t vertexHash = std::hash<std::string_view>()(vertexBytes);
+    const size_t indexHash = std::hash<std::string_view>()(indexBytes);
+    return vertexHash ^ (indexHash + 0x9e3779b9 + (vertexHash << 6) + (vertexHash >> 2));
+}
+
+bool MeshRegistry::isContentEqual(const PolygonalMesh &lhs, const PolygonalMesh &rhs)
+{
+    return lhs.vertices.size() == rhs.vertices.size()
+        && lhs.indices.size() == rhs.indices.size()
+        && std::memcmp(lhs.vertices.data(), rhs.vertices.data(), lhs.vertices.size() * sizeof(Vertex)) == 0
+        && std::memcmp(lhs.indices.data(), rhs.indices.data(), lhs.indices.size() * sizeof(unsigned int)) == 0;
+}
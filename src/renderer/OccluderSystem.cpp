@@ -0,0 +1,22 @@
+/**
+ * @file OccluderSystem.cpp
+ * @brief Rasterises occluders into the occlusion culler.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "OccluderSystem.h"
+
+void OccluderSystem::rasterize(OcclusionCuller &culler, const MeshRegistry &meshRegistry)
+{
+    view<const Occluder, const WorldTransform>().each(
+        [&](ecs::entity entity, const Occluder &occluder, const WorldTransform &world) {
+            MeshHandle mesh = occluder.mesh;
+            if (!mesh.isValid() && hasComponent<MeshHandle>(entity)) { mesh = getComponent<const MeshHandle>(entity); }
+            if (!mesh.isValid()) { return; }
+
+            const PolygonalMesh &polygonalMesh = meshRegistry.get(mesh);
+            culler.addOccluder(polygonalMesh.vertices, polygonalMesh.indices, world.matrix);
+        });
+}
@@ -0,0 +1,300 @@
+/**
+ * @file OcclusionCuller.cpp
+ * @brief Rasterises occluders into a small depth buffer and tests bounding boxes against it.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX__)
+    #define OCCLUSION_CULLER_AVX
+    #include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define OCCLUSION_CULLER_SSE
+    #include <xmmintrin.h>
+#endif
+
+#if defined(OCCLUSION_CULLER_AVX)
+    const size_t OcclusionCuller::batchSize = 8;
+#elif defined(OCCLUSION_CULLER_SSE)
+    const size_t OcclusionCuller::batchSize = 4;
+#else
+    const size_t OcclusionCuller::batchSize = 1;
+#endif
+
+namespace
+{
+    /** dot((a, b, c), (x, y, 1)), which is positive on the inside of a counter-clockwise edge. */
+    struct edge
+    {
+        float a;
+        float b;
+        float c;
+
+        edge(const glm::vec3 &from, const glm::vec3 &to)
+            : a(from.y - to.y), b(to.x - from.x), c(-(a * from.x + b * from.y)) {}
+    };
+}
+
+OcclusionCuller::OcclusionCuller(int width, int height)
+{
+    resize(width, height);
+}
+
+void OcclusionCuller::resize(int width, int height)
+{
+    mWidth = (std::max(width, 1) + tileWidth - 1) / tileWidth * tileWidth;
+    mHeight = (std::max(height, 1) + tileHeight - 1) / tileHeight * tileHeight;
+
+    mLevels.clear();
+    int levelWidth = mWidth;
+    int levelHeight = mHeight;
+    while (true)
+    {
+        mLevels.push_back({ levelWidth, levelHeight, std::vector<float>(levelWidth * levelHeight, 1.f) });
+        if (levelWidth == 1 && levelHeight == 1) { break; }
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+}
+
+void OcclusionCuller::begin(const glm::mat4 &vpMatrix)
+{
+    mVpMatrix = vpMatrix;
+    mTriangleCount = 0;
+    std::fill(mLevels[0].depth.begin(), mLevels[0].depth.end(), 1.f);
+}
+
+void OcclusionCuller::addOccluder(const std::vector<glm::vec3> &positions, const std::vector<unsigned int> &indices,
+                                  const glm::mat4 &modelMatrix)
+{
+    const glm::mat4 mvpMatrix = mVpMatrix * modelMatrix;
+    mClipPositions.clear();
+    for (const glm::vec3 &position : positions) { mClipPositions.push_back(mvpMatrix * glm::vec4(position, 1.f)); }
+    rasterizeTriangles(indices);
+}
+
+void OcclusionCuller::rasterizeTriangles(const std::vector<unsigned int> &indices)
+{
+    const glm::vec2 size(static_cast<float>(mWidth), static_cast<float>(mHeight));
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        std::array<glm::vec3, 3> screen;
+        bool crossesNearPlane = false;
+        for (size_t corner = 0; corner < 3; ++corner)
+        {
+            const glm::vec4 &clip = mClipPositions[indices[i + corner]];
+            if (clip.w <= 0.f || clip.z < -clip.w) { crossesNearPlane = true; break; }
+            const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            screen[corner] = glm::vec3((glm::vec2(ndc) * 0.5f + 0.5f) * size, ndc.z * 0.5f + 0.5f);
+        }
+        if (crossesNearPlane) { continue; }
+        rasterizeTriangle(screen[0], screen[1], screen[2]);
+    }
+}
+
+void OcclusionCuller::rasterizeTriangle(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c)
+{
+    const float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (!(area > 0.f)) { return; }  // Back facing, degenerate or NaN.
+
+    // Only pixels whose centres are inside of the bounding box can be covered. Clamping first keeps the casts safe.
+    const float right = static_cast<float>(mWidth);
+    const float top = static_cast<float>(mHeight);
+    const int firstX = static_cast<int>(std::ceil(std::clamp(std::min({ a.x, b.x, c.x }), 0.f, right) - 0.5f));
+    const int firstY = static_cast<int>(std::ceil(std::clamp(std::min({ a.y, b.y, c.y }), 0.f, top) - 0.5f));
+    const int lastX = static_cast<int>(std::floor(std::clamp(std::max({ a.x, b.x, c.x }), 0.f, right) - 0.5f));
+    const int lastY = static_cast<int>(std::floor(std::clamp(std::max({ a.y, b.y, c.y }), 0.f, top) - 0.5f));
+    if (firstX > lastX || firstY > lastY) { return; }
+    ++mTriangleCount;
+
+    // Each edge's function is the barycentric weight of the opposite corner, scaled by the area.
+    const std::array<edge, 3> edges { edge(b, c), edge(c, a), edge(a, b) };
+    const float inverseArea = 1.f / area;
+    const float depthA = (edges[0].a * a.z + edges[1].a * b.z + edges[2].a * c.z) * inverseArea;
+    const float depthB = (edges[0].b * a.z + edges[1].b * b.z + edges[2].b * c.z) * inverseArea;
+    const float depthC = (edges[0].c * a.z + edges[1].c * b.z + edges[2].c * c.z) * inverseArea;
+
+    std::vector<float> &depth = mLevels[0].depth;
+    for (int tileY = firstY / tileHeight * tileHeight; tileY <= lastY; tileY += tileHeight)
+    {
+        for (int tileX = firstX / tileWidth * tileWidth; tileX <= lastX; tileX += tileWidth)
+        {
+            // Edge functions are linear, so their extremes over the tile are at the corner pixels' centres.
+            const float tileLeft = static_cast<float>(tileX) + 0.5f;
+            const float tileRight = tileLeft + static_cast<float>(tileWidth - 1);
+            const float tileBottom = static_cast<float>(tileY) + 0.5f;
+            const float tileTop = tileBottom + static_cast<float>(tileHeight - 1);
+            bool outside = false;
+            bool covered = true;
+            for (const edge &e : edges)
+            {
+                const float highest = e.a * (e.a > 0.f ? tileRight : tileLeft) + e.b * (e.b > 0.f ? tileTop : tileBottom) + e.c;
+                const float lowest = e.a * (e.a > 0.f ? tileLeft : tileRight) + e.b * (e.b > 0.f ? tileBottom : tileTop) + e.c;
+                if (highest < 0.f) { outside = true; break; }
+                if (lowest < 0.f) { covered = false; }
+            }
+            if (outside) { continue; }
+
+            const int rowBegin = covered ? tileY : std::max(tileY, firstY);
+            const int rowEnd = covered ? tileY + tileHeight - 1 : std::min(tileY + tileHeight - 1, lastY);
+            for (int y = rowBegin; y <= rowEnd; ++y)
+            {
+                const float centreY = static_cast<float>(y) + 0.5f;
+                const float row0 = edges[0].b * centreY + edges[0].c;
+                const float row1 = edges[1].b * centreY + edges[1].c;
+                const float row2 = edges[2].b * centreY + edges[2].c;
+                const float rowDepth = depthB * centreY + depthC;
+                float *out = &depth[static_cast<size_t>(y) * mWidth];
+
+                for (int x = tileX; x < tileX + tileWidth; x += static_cast<int>(batchSize))
+                {
+#if defined(OCCLUSION_CULLER_AVX)
+                    const __m256 centreX = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)),
+                                                         _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f));
+                    const __m256 zero = _mm256_setzero_ps();
+                    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+                    if (!covered)
+                    {
+                        const __m256 e0 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(edges[0].a), centreX), _mm256_set1_ps(row0));
+                        const __m256 e1 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(edges[1].a), centreX), _mm256_set1_ps(row1));
+                        const __m256 e2 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(edges[2].a), centreX), _mm256_set1_ps(row2));
+                        inside = _mm256_and_ps(_mm256_cmp_ps(e0, zero, _CMP_GE_OQ), _mm256_cmp_ps(e1, zero, _CMP_GE_OQ));
+                        inside = _mm256_and_ps(inside, _mm256_cmp_ps(e2, zero, _CMP_GE_OQ));
+                    }
+                    const __m256 z = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(depthA), centreX), _mm256_set1_ps(rowDepth));
+                    const __m256 stored = _mm256_loadu_ps(out + x);
+                    _mm256_storeu_ps(out + x, _mm256_blendv_ps(stored, _mm256_min_ps(stored, z), inside));
+#elif defined(OCCLUSION_CULLER_SSE)
+                    const __m128 centreX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+                    const __m128 zero = _mm_setzero_ps();
+                    __m128 inside = _mm_cmpeq_ps(zero, zero);
+                    if (!covered)
+                    {
+                        const __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edges[0].a), centreX), _mm_set1_ps(row0));
+                        const __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edges[1].a), centreX), _mm_set1_ps(row1));
+                        const __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edges[2].a), centreX), _mm_set1_ps(row2));
+                        inside = _mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero));
+                        inside = _mm_and_ps(inside, _mm_cmpge_ps(e2, zero));
+                    }
+                    const __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(depthA), centreX), _mm_set1_ps(rowDepth));
+                    const __m128 stored = _mm_loadu_ps(out + x);
+                    const __m128 nearer = _mm_min_ps(stored, z);
+                    _mm_storeu_ps(out + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, stored)));
+#else
+                    const float centreX = static_cast<float>(x) + 0.5f;
+                    const bool inside = covered || (edges[0].a * centreX + row0 >= 0.f
+                                                 && edges[1].a * centreX + row1 >= 0.f
+                                                 && edges[2].a * centreX + row2 >= 0.f);
+                    if (inside) { out[x] = std::min(out[x], depthA * centreX + rowDepth); }
+#endif
+                }
+            }
+        }
+    }
+}
+
+void OcclusionCuller::buildHiZ()
+{
+    for (size_t i = 1; i < mLevels.size(); ++i)
+    {
+        const level &below = mLevels[i - 1];
+        level &current = mLevels[i];
+        for (int y = 0; y < current.height; ++y)
+        {
+            // Odd sized levels repeat their last row and column.
+            const size_t row0 = static_cast<size_t>(2 * y) * below.width;
+            const size_t row1 = static_cast<size_t>(std::min(2 * y + 1, below.height - 1)) * below.width;
+            for (int x = 0; x < current.width; ++x)
+            {
+                const int x0 = 2 * x;
+                const int x1 = std::min(2 * x + 1, below.width - 1);
+                current.depth[static_cast<size_t>(y) * current.width + x] = std::max(
+                    std::max(below.depth[row0 + x0], below.depth[row0 + x1]),
+                    std::max(below.depth[row1 + x0], below.depth[row1 + x1]));
+            }
+        }
+    }
+}
+
+OcclusionCuller::footprint OcclusionCuller::findFootprint(const glm::vec3 &min, const glm::vec3 &max,
+                                                          const glm::mat4 &modelMatrix, screenRect &rect) const
+{
+    const glm::mat4 mvpMatrix = mVpMatrix * modelMatrix;
+    glm::vec2 lowest(std::numeric_limits<float>::max());
+    glm::vec2 highest(std::numeric_limits<float>::lowest());
+    rect.nearest = std::numeric_limits<float>::max();
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        const glm::vec3 position((corner & 1) ? max.x : min.x, (corner & 2) ? max.y : min.y, (corner & 4) ? max.z : min.z);
+        const glm::vec4 clip = mvpMatrix * glm::vec4(position, 1.f);
+        if (clip.w <= 0.f || clip.z < -clip.w) { return footprint::CrossesNearPlane; }
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        lowest = glm::min(lowest, glm::vec2(ndc));
+        highest = glm::max(highest, glm::vec2(ndc));
+        rect.nearest = std::min(rect.nearest, ndc.z * 0.5f + 0.5f);
+    }
+
+    // Every pixel that the box touches is included, not just the ones whose centres it covers.
+    const glm::vec2 size(static_cast<float>(mWidth), static_cast<float>(mHeight));
+    lowest = glm::floor((lowest * 0.5f + 0.5f) * size);
+    highest = glm::floor((highest * 0.5f + 0.5f) * size);
+    if (highest.x < 0.f || highest.y < 0.f || lowest.x >= size.x || lowest.y >= size.y)
+    {
+        return footprint::Offscreen;
+    }
+    rect.minX = std::max(0, static_cast<int>(lowest.x));
+    rect.minY = std::max(0, static_cast<int>(lowest.y));
+    rect.maxX = std::min(mWidth - 1, static_cast<int>(std::min(highest.x, size.x)));
+    rect.maxY = std::min(mHeight - 1, static_cast<int>(std::min(highest.y, size.y)));
+    return footprint::OnScreen;
+}
+
+bool OcclusionCuller::isVisible(const glm::vec3 &min, const glm::vec3 &max, const glm::mat4 &modelMatrix) const
+{
+    screenRect rect { };
+    const footprint result = findFootprint(min, max, modelMatrix, rect);
+    if (result != footprint::OnScreen) { return result == footprint::CrossesNearPlane; }
+
+    // Picks the level where the rect spans at most three texels in each direction. The level above it would only
+    // need two but hides far less, since each of its texels is the furthest depth over four times the area.
+    const int extent = std::max(rect.maxX - rect.minX, rect.maxY - rect.minY) + 1;
+    size_t levelIndex = 0;
+    while ((2 << levelIndex) < extent && levelIndex + 1 < mLevels.size()) { ++levelIndex; }
+
+    const level &hiZ = mLevels[levelIndex];
+    const int shift = static_cast<int>(levelIndex);
+    for (int y = rect.minY >> shift; y <= rect.maxY >> shift; ++y)
+    {
+        for (int x = rect.minX >> shift; x <= rect.maxX >> shift; ++x)
+        {
+            if (hiZ.depth[static_cast<size_t>(y) * hiZ.width + x] >= rect.nearest) { return true; }
+        }
+    }
+    return false;
+}
+
+bool OcclusionCuller::isVisibleReference(const glm::vec3 &min, const glm::vec3 &max,
+                                         const glm::mat4 &modelMatrix) const
+{
+    screenRect rect { };
+    const footprint result = findFootprint(min, max, modelMatrix, rect);
+    if (result != footprint::OnScreen) { return result == footprint::CrossesNearPlane; }
+
+    const std::vector<float> &depth = mLevels[0].depth;
+    for (int y = rect.minY; y <= rect.maxY; ++y)
+    {
+        for (int x = rect.minX; x <= rect.maxX; ++x)
+        {
+            if (depth[static_cast<size_t>(y) * mWidth + x] >= rect.nearest) { return true; }
+        }
+    }
+    return false;
+}
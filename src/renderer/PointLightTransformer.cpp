@@ -8,34 +8,48 @@
 
 #include "PointLightTransformer.h"
 
-void PointLightTransformer::calculateLightPositions(Shader &shader)
+void PointLightTransformer::init(const Shader &shader)
 {
-    int i = 0;
-    for (const auto &entity : mEntities)
+    mCameraPositionWs = shader.getUniform<glm::vec4>("u_camera_position_ws");
+    for (mActiveLights = 0; mActiveLights < maxLights; ++mActiveLights)
     {
-        const auto &lightTransform = getComponent<Transform>(entity);
-        shader.setUniform(
-                "u_lights[" + std::to_string(i) + "].position_ws",
-                glm::vec4(lightTransform.position, 1.f)
-        );
-        ++i;
+        const std::string light = "u_lights[" + std::to_string(mActiveLights) + "].";
+        if (!shader.hasUniform(light + "colour")) { break; }
+
+        mLightUniforms[mActiveLights] = {
+            shader.getUniform<glm::vec4>(light + "position_ws"),
+            shader.getUniform<glm::vec4>(light + "colour"),
+            shader.getUniform<float>(light + "intensity"),
+            shader.getUniform<float>(light + "fall_off")
+        };
+    }
+}
+
+void PointLightTransformer::gatherLights(ecs::entity mainCamera)
+{
+    // The view matrix already includes the camera's parents, so its inverse is the camera's world matrix.
+    mCameraPosition = glm::inverse(getComponent<const CameraMatrices>(mainCamera).viewMatrix)[3];
+
+    mLightCount = 0;
+    for (const auto &[light, lightTransform] : view<const PointLight, const WorldTransform>())
+    {
+        if (mLightCount == mActiveLights) { break; }
+        mLights[mLightCount++] = {
+            lightTransform.matrix[3], glm::vec4(light.kDiffuse, 1.f), light.intensity, light.fallOff
+        };
     }
 }
 
-void PointLightTransformer::setShaderLights(ecs::entity mainCamera, Shader &shader)
+void PointLightTransformer::setShaderLights(const Shader &shader) const
 {
-    calculateLightPositions(shader);
-    int i = 0;
-    const auto &cameraPosition = getComponent<Transform>(mainCamera).position;
-    shader.setUniform("u_camera_position_ws", glm::vec4(-cameraPosition, 1.f));
-    for (const auto &entity : mEntities)
+    shader.setUniform(mCameraPositionWs, mCameraPosition);
+    for (size_t i = 0; i < mLightCount; ++i)
     {
-        const auto &light = getComponent<PointLight>(entity);
-        const auto &lightPos = getComponent<Transform>(entity).position;
-        std::string stringI = std::to_string(i);
-        shader.setUniform("u_lights[" + stringI + "].colour", glm::vec4(light.kDiffuse, 1.f));
-        shader.setUniform("u_lights[" + stringI + "].intensity", light.intensity);
-        shader.setUniform("u_lights[" + stringI + "].fall_off", light.fallOff);
-        ++i;
+        const lightUniforms &uniforms = mLightUniforms[i];
+        const lightValues &light = mLights[i];
+        shader.setUniform(uniforms.positionWs, light.positionWs);
+        shader.setUniform(uniforms.colour, light.colour);
+        shader.setUniform(uniforms.intensity, light.intensity);
+        shader.setUniform(uniforms.fallOff, light.fallOff);
     }
 }
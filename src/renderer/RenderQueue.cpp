@@ -0,0 +1,132 @@
+/**
+ * @file RenderQueue.cpp
+ * @brief Builds and radix sorts the keys that decide the order of draws.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace
+{
+    constexpr uint64_t mask(int bits) { return (uint64_t { 1 } << bits) - 1; }
+
+    // Where each field starts in an opaque key.
+    constexpr int opaqueDepthShift { 0 };
+    constexpr int opaqueBatchShift { opaqueDepthShift + RenderQueue::depthBits };
+    constexpr int opaqueTexturesShift { opaqueBatchShift + RenderQueue::batchBits };
+    constexpr int opaqueShaderShift { opaqueTexturesShift + RenderQueue::texturesBits };
+
+    // Where each field starts in a transparent key.
+    constexpr int transparentBatchShift { 0 };
+    constexpr int transparentTexturesShift { transparentBatchShift + RenderQueue::batchBits };
+    constexpr int transparentShaderShift { transparentTexturesShift + RenderQueue::texturesBits };
+    constexpr int transparentDepthShift { transparentShaderShift + RenderQueue::shaderBits };
+
+    constexpr int passShift { 62 };
+    static_assert(opaqueShaderShift + RenderQueue::shaderBits == passShift, "Opaque key fields must fill the key.");
+    static_assert(transparentDepthShift + RenderQueue::depthBits == passShift, "Transparent key fields must fill the key.");
+
+    /**
+     * Positive floats sort the same way as their bits. Dropping the lowest bits keeps the exponent and the top of the
+     * mantissa, which is plenty to order draws by.
+     */
+    uint64_t quantiseDepth(float depth)
+    {
+        const uint32_t bits = std::bit_cast<uint32_t>(std::max(depth, 0.f));
+        return bits >> (32 - 1 - RenderQueue::depthBits);
+    }
+}
+
+uint64_t RenderQueue::makeKey(pass renderPass, unsigned int shader, unsigned int textures, unsigned int batch,
+                              float depth)
+{
+    const uint64_t quantisedDepth = quantiseDepth(depth);
+    if (renderPass == pass::Opaque)
+    {
+        return (shader & mask(shaderBits)) << opaqueShaderShift
+             | (textures & mask(texturesBits)) << opaqueTexturesShift
+             | (batch & mask(batchBits)) << opaqueBatchShift
+             | quantisedDepth << opaqueDepthShift;
+    }
+
+    return uint64_t { 1 } << passShift
+         | (mask(depthBits) - quantisedDepth) << transparentDepthShift
+         | (shader & mask(shaderBits)) << transparentShaderShift
+         | (textures & mask(texturesBits)) << transparentTexturesShift
+         | (batch & mask(batchBits)) << transparentBatchShift;
+}
+
+unsigned int RenderQueue::getShader(uint64_t key)
+{
+    const int shift = getPass(key) == pass::Opaque ? opaqueShaderShift : transparentShaderShift;
+    return static_cast<unsigned int>(key >> shift & mask(shaderBits));
+}
+
+unsigned int RenderQueue::getTextures(uint64_t key)
+{
+    const int shift = getPass(key) == pass::Opaque ? opaqueTexturesShift : transparentTexturesShift;
+    return static_cast<unsigned int>(key >> shift & mask(texturesBits));
+}
+
+unsigned int RenderQueue::getBatch(uint64_t key)
+{
+    const int shift = getPass(key) == pass::Opaque ? opaqueBatchShift : transparentBatchShift;
+    return static_cast<unsigned int>(key >> shift & mask(batchBits));
+}
+
+uint64_t RenderQueue::replaceIds(uint64_t key, unsigned int textures, unsigned int batch)
+{
+    const bool opaque = getPass(key) == pass::Opaque;
+    const int texturesShift = opaque ? opaqueTexturesShift : transparentTexturesShift;
+    const int batchShift = opaque ? opaqueBatchShift : transparentBatchShift;
+    return (key & ~(mask(texturesBits) << texturesShift) & ~(mask(batchBits) << batchShift))
+         | (textures & mask(texturesBits)) << texturesShift
+         | (batch & mask(batchBits)) << batchShift;
+}
+
+uint64_t RenderQueue::getState(uint64_t key)
+{
+    const int shift = getPass(key) == pass::Opaque ? opaqueDepthShift : transparentDepthShift;
+    return key & ~(mask(depthBits) << shift);
+}
+
+void RenderQueue::sort()
+{
+    mLastSortPasses = 0;
+    const size_t count = mItems.size();
+    if (count < 2) { return; }
+
+    // Every byte's histogram is counted in one read of the keys.
+    std::array<std::array<size_t, 256>, 8> histograms { };
+    for (const item &current : mItems)
+    {
+        for (size_t byte = 0; byte < 8; ++byte) { ++histograms[byte][current.key >> (byte * 8) & 0xFF]; }
+    }
+
+    mScratch.resize(count);
+    for (size_t byte = 0; byte < 8; ++byte)
+    {
+        std::array<size_t, 256> &histogram = histograms[byte];
+
+        // Every key has the same value for this byte, so the order wouldn't change.
+        if (histogram[mItems.front().key >> (byte * 8) & 0xFF] == count) { continue; }
+
+        size_t offset = 0;
+        for (size_t &bucket : histogram)
+        {
+            const size_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+
+        for (const item &current : mItems) { mScratch[histogram[current.key >> (byte * 8) & 0xFF]++] = current; }
+        mItems.swap(mScratch);
+        ++mLastSortPasses;
+    }
+}
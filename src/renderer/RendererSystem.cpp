@@ -14,96 +14,406 @@
 #include <iostream>
 #include <algorithm>
 #include <numeric>
+#include <cmath>
 
 RendererSystem::RendererSystem()
 {
-    glGenBuffers(1, &mVertexBufferId);
-    glGenBuffers(1, &mIndexBufferId);
-    glGenVertexArrays(1, &mVertexArrayId);
-    glGenTextures(1, &mCurrentTexturesId);
+    glClearColor(0.16f, 0.16f, 0.16f, 1.f);
+}
 
-    glBindVertexArray(mVertexArrayId);
-    glBindBuffer(GL_ARRAY_BUFFER, mVertexBufferId);
+void RendererSystem::init()
+{
+    const Shader &shader = mMaterialProcessor->mShader;
+    mVpMatrixUniform = shader.getUniform<glm::mat4>("u_vp_matrix");
+    mViewMatrixUniform = shader.getUniform<glm::mat4>("u_view_matrix");
+    mPointLightTransformer->init(shader);
+    buildFrameGraph();
+}
 
-    glEnableVertexAttribArray(0);  // Position
-    glEnableVertexAttribArray(1);  // UV Coord
-    glEnableVertexAttribArray(2);  // Normal
-    glEnableVertexAttribArray(3);  // Tangent
-    glEnableVertexAttribArray(4);  // BiTangent
-    glEnableVertexAttribArray(5);  // Texture Id
+void RendererSystem::setMainCamera(ecs::entity entity)
+{
+    mMainCamera = entity;
+}
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, Vertex::stride(), reinterpret_cast<void *>(offsetof(Vertex, position)));
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, Vertex::stride(), reinterpret_cast<void *>(offsetof(Vertex, uvCoord)));
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, Vertex::stride(), reinterpret_cast<void *>(offsetof(Vertex, normal)));
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, Vertex::stride(), reinterpret_cast<void *>(offsetof(Vertex, tangent)));
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, Vertex::stride(), reinterpret_cast<void *>(offsetof(Vertex, biTangent)));
-    glVertexAttribIPointer(5, 1, GL_INT, Vertex::stride(), reinterpret_cast<void *>(offsetof(Vertex, textureId)));
+void RendererSystem::buildFrameGraph()
+{
+    glCreateFramebuffers(1, &mPresentFramebuffer);
 
-    glClearColor(0.16f, 0.16f, 0.16f, 1.f);
+    const FrameGraph::resource instances = mFrameGraph.importBuffer("Instances", mInstanceBuffer.getId());
+    const FrameGraph::resource commands = mFrameGraph.importBuffer("Draw Commands", mCommandBuffer.getId());
+    const FrameGraph::resource materials = mFrameGraph.importBuffer(
+        "Materials", mMaterialProcessor->getMaterialPool().getId());
+    const FrameGraph::resource sceneColour = mFrameGraph.createTexture("Scene Colour", { GL_RGBA8 });
+    const FrameGraph::resource sceneDepth = mFrameGraph.createTexture("Scene Depth", { GL_DEPTH_COMPONENT24 });
+
+    mFrameGraph.addPass("Upload",
+        [&](FrameGraph::builder &builder) {
+            builder.write(instances);
+            builder.write(commands);
+            builder.write(materials);
+        },
+        [this](const FrameGraph::context &) {
+            mInstanceBuffer.upload(mInstances);
+            mCommandBuffer.upload(mCommands);
+            mMaterialProcessor->uploadMaterials();
+        });
+
+    mFrameGraph.addPass("Forward",
+        [&](FrameGraph::builder &builder) {
+            builder.read(instances);
+            builder.read(commands);
+            builder.read(materials);
+            builder.write(sceneColour);
+            builder.write(sceneDepth);
+        },
+        [this](const FrameGraph::context &) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            if (mBuckets.empty()) { return; }
+
+            mMaterialProcessor->bind();
+            mMeshRegistry.getArena().bind();
+
+            const Shader &shader = mMaterialProcessor->mShader;
+            mPointLightTransformer->setShaderLights(shader);
+            shader.setUniform(mVpMatrixUniform, mVpMatrix);
+            shader.setUniform(mViewMatrixUniform, mViewMatrix);
+
+            mInstanceBuffer.bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+            mCommandBuffer.bind(GL_DRAW_INDIRECT_BUFFER);
+            drawBuckets();
+        });
+
+    // Blitting leaves the window's framebuffer free of depth and multisampling requirements.
+    mFrameGraph.addPass("Present",
+        [&](FrameGraph::builder &builder) {
+            builder.read(sceneColour);
+            builder.write(mFrameGraph.getBackbuffer());
+        },
+        [this, sceneColour](const FrameGraph::context &context) {
+            const glm::ivec2 size = context.getSize();
+            glNamedFramebufferTexture(mPresentFramebuffer, GL_COLOR_ATTACHMENT0, context.getTexture(sceneColour), 0);
+            glBlitNamedFramebuffer(mPresentFramebuffer, context.getFramebuffer(), 0, 0, size.x, size.y,
+                                   0, 0, size.x, size.y, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        });
 }
 
-void RendererSystem::setMainCamera(ecs::entity entity)
+void RendererSystem::render(const glm::ivec2 &resolution)
 {
-    mMainCamera = entity;
+    beginRun();
+
+    // Every mesh is already on the GPU, so nothing is uploaded here unless a mesh was added this frame.
+    mMeshUploadBytes = mMeshRegistry.getArena().takeUploadedBytes();
+
+    // Materials are updated first so that the draw lists see which ones are transparent this frame.
+    mMaterialProcessor->updateMaterials();
+    mPointLightTransformer->gatherLights(mMainCamera);
+    const auto &cameraMats = getComponent<const CameraMatrices>(mMainCamera);
+    mVpMatrix = cameraMats.vpMatrix;
+    mViewMatrix = cameraMats.viewMatrix;
+    buildDrawLists(mVpMatrix);
+
+    mFrameGraph.setBackbufferSize(resolution);
+    mFrameGraph.execute();
 }
 
-void RendererSystem::render()
+void RendererSystem::drawBuckets() const
 {
-    mMaterialProcessor->bind();
-    computeModels();
+    // One call per set of textures. Each command's baseInstance says where its instances start in mInstances.
+    // Buckets are in pass order, so blending is turned on once when the first transparent one is reached.
+    glDisable(GL_BLEND);
+    bool blending = false;
+    for (const drawBucket &bucket : mBuckets)
+    {
+        if (!blending && bucket.renderPass == RenderQueue::pass::Transparent)
+        {
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            glDepthMask(GL_FALSE);
+            blending = true;
+        }
+        mMaterialProcessor->bindTextures(bucket.diffuseTexturesId, bucket.normalMapId);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                    reinterpret_cast<void *>(bucket.first * sizeof(drawElementsIndirectCommand)),
+                                    static_cast<GLsizei>(bucket.count), 0);
+    }
 
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    if (blending)
+    {
+        glDisable(GL_BLEND);
+        glDepthMask(GL_TRUE);
+    }
+}
 
-    glBindVertexArray(mVertexArrayId);
-    glBindBuffer(GL_ARRAY_BUFFER, mVertexBufferId);  // Binding a buffer does not attach it to a VAO.
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBufferId);
+void RendererSystem::buildDrawLists(const glm::mat4 &vpMatrix)
+{
+    mVisibleEntities.clear();
+    if (mSpatialSystem) { gatherFromSpatialSystem(vpMatrix); }
+    else { gatherByCulling(vpMatrix); }
 
-    // Process Lights
-    const auto &cameraMats = getComponent<CameraMatrices>(mMainCamera);
-    mPointLightTransformer->setShaderLights(mMainCamera, mMaterialProcessor->mShader);
+    // Occluded entities are only counted by mOccludedCount. Visible entities with nothing to draw aren't culled.
+    mCulledCount = mTestedCount - mVisibleEntities.size();
 
-    for (const auto &entity : mEntities)
+    const bool occlusion = rasterizeOccluders(vpMatrix);
+
+    // Each chunk's packets go into their own list. Lists are merged in chunk order, so the packets end up in the
+    // same order as if they were built on one thread.
+    const size_t listCount = findChunkCount(mVisibleEntities.size());
+    if (mPacketLists.size() < listCount) { mPacketLists.resize(listCount); }
+    for (packetList &list : mPacketLists)
     {
-        const auto &mesh = getComponent<PolygonalMesh>(entity);
-        const auto &uniforms = getComponent<RendererUniforms>(entity);
+        // Local ids are never given back either. Lists with more than could fit in a key are mostly stale.
+        if (list.textures.local.values.size() >= size_t { 1 } << RenderQueue::texturesBits) { list.textures.clear(); }
+        if (list.batches.local.values.size() >= size_t { 1 } << RenderQueue::batchBits) { list.batches.clear(); }
+    }
+    parallelForChunks(mVisibleEntities.size(), listCount, [&](size_t chunk, size_t begin, size_t end) {
+        buildPackets(mPacketLists[chunk], begin, end, vpMatrix, occlusion);
+    });
+    mergePackets(listCount);
 
-        glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * Vertex::stride(), &mesh.vertices[0], GL_DYNAMIC_DRAW);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof (unsigned int), &mesh.indices[0], GL_DYNAMIC_DRAW);
+    // Radix sorting is stable, so draws with equal keys stay in the order that their entities were visited.
+    mRenderQueue.sort();
+    buildCommands();
+}
 
-        // Process Uniforms
-        mMaterialProcessor->mShader.setUniform("u_mvp_matrix", uniforms.mvp);
-        mMaterialProcessor->mShader.setUniform("u_model_matrix", uniforms.modelMat);
-        mMaterialProcessor->mShader.setUniform("u_view_matrix", cameraMats.viewMatrix);
-        mMaterialProcessor->setupMaterials(uniforms.materialIds, uniforms.diffuseTexturesId, uniforms.normalMapId);
+void RendererSystem::buildPackets(packetList &list, size_t begin, size_t end, const glm::mat4 &vpMatrix,
+                                  bool occlusion)
+{
+    // The clip space w of a point is its distance along the view direction.
+    const glm::vec4 depthRow(vpMatrix[0][3], vpMatrix[1][3], vpMatrix[2][3], vpMatrix[3][3]);
 
-        glDrawElements(GL_TRIANGLES, mesh.indices.size(), GL_UNSIGNED_INT, nullptr);
+    list.packets.clear();
+    list.occludedCount = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        const ecs::entity entity = mVisibleEntities[i];
+        if (!mEntities.contains(entity)) { continue; }  // Has bounds but nothing to draw.
+        const auto &world = getComponent<const WorldTransform>(entity);
+        const auto &bounds = getComponent<const Bounds>(entity);
+        if (occlusion && !mOcclusionCuller.isVisible(bounds.min, bounds.max, world.matrix))
+        {
+            ++list.occludedCount;
+            continue;
+        }
+        const float depth = glm::dot(depthRow, world.matrix * glm::vec4(bounds.centre, 1.f));
+        addPacket(list, getComponent<const MeshHandle>(entity), getComponent<const RendererUniforms>(entity),
+                  world, depth);
     }
 }
 
-void RendererSystem::setTextures(const TextureIds &textures) const
+void RendererSystem::mergePackets(size_t listCount)
 {
-    glBindTexture(GL_TEXTURE_2D, mCurrentTexturesId);
-    for (int i = 0; i < textures.size(); i++)
+    size_t packetCount = 0;
+    mOccludedCount = 0;
+    for (size_t i = 0; i < listCount; ++i)
     {
-        glBindTextureUnit(i, textures[i]);
+        packetList &list = mPacketLists[i];
+        list.first = packetCount;
+        packetCount += list.packets.size();
+        mOccludedCount += list.occludedCount;
     }
+
+    shareIds(mTextures, &packetList::textures, &renderPacket::textures, RenderQueue::texturesBits, listCount);
+    shareIds(mBatches, &packetList::batches, &renderPacket::batch, RenderQueue::batchBits, listCount);
+
+    mPackets.resize(packetCount);
+    mRenderQueue.resize(packetCount);
+    parallelForChunks(listCount, listCount, [this](size_t chunk, size_t, size_t) {
+        const packetList &list = mPacketLists[chunk];
+        for (size_t i = 0; i < list.packets.size(); ++i)
+        {
+            renderPacket packet = list.packets[i];
+            packet.key = RenderQueue::replaceIds(packet.key, list.textures.shared[packet.textures],
+                                                 list.batches.shared[packet.batch]);
+            const size_t index = list.first + i;
+            mPackets[index] = packet;
+            mRenderQueue.set(index, packet.key, static_cast<unsigned int>(index));
+        }
+    });
 }
 
-void RendererSystem::computeModels()
+void RendererSystem::shareIds(idTable &table, localIdTable packetList::*ids, unsigned int renderPacket::*packetId,
+                              int bits, size_t listCount)
 {
-    const auto &camera = getComponent<CameraMatrices>(mMainCamera);
+    size_t queuedCount = 0;
+    for (size_t i = 0; i < listCount; ++i) { queuedCount += (mPacketLists[i].*ids).queue.size(); }
 
-    std::vector<glm::mat4> modelMatrices;
-    for (auto &entity : mEntities)
+    // Shared ids are never given back, so start again before they can run out of bits in the sort keys.
+    if (table.values.size() + queuedCount >= size_t { 1 } << bits)
     {
-        auto &rendererMaterial = getComponent<RendererUniforms>(entity);
-        const auto &transform = getComponent<Transform>(entity);
-
-        glm::mat4 translation = glm::translate(glm::mat4(1.f), transform.position);
-        glm::mat4 rotation = glm::toMat4(transform.rotation);
-        glm::mat4 scale = glm::scale(glm::mat4(1.f), transform.scale);
-        glm::mat4 model = translation * rotation * scale;
-        rendererMaterial.mvp = camera.vpMatrix * model;
-        rendererMaterial.modelMat = model;
+        table.clear();
+        for (packetList &list : mPacketLists) { (list.*ids).unshare(); }
+        for (size_t i = 0; i < listCount; ++i)
+        {
+            for (const renderPacket &packet : mPacketLists[i].packets) { (mPacketLists[i].*ids).use(packet.*packetId); }
+        }
     }
+
+    for (size_t i = 0; i < listCount; ++i) { (mPacketLists[i].*ids).share(table); }
+}
+
+void RendererSystem::buildCommands()
+{
+    const std::vector<RenderQueue::item> &items = mRenderQueue.getItems();
+    mInstances.resize(items.size());
+    parallelForChunks(items.size(), findChunkCount(items.size()), [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) { mInstances[i] = mPackets[items[i].instance].instance; }
+    });
+
+    mCommands.clear();
+    mBuckets.clear();
+    mTransparentCount = 0;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        const RenderQueue::item &item = items[i];
+        const RenderQueue::pass renderPass = RenderQueue::getPass(item.key);
+        const unsigned int textures = RenderQueue::getTextures(item.key);
+        if (renderPass == RenderQueue::pass::Transparent) { ++mTransparentCount; }
+
+        const bool newBucket = i == 0
+            || renderPass != RenderQueue::getPass(items[i - 1].key)
+            || textures != RenderQueue::getTextures(items[i - 1].key);
+        if (newBucket)
+        {
+            const uint64_t textureArrays = mTextures.values[textures];
+            mBuckets.push_back({
+                renderPass,
+                static_cast<unsigned int>(textureArrays >> 32),
+                static_cast<unsigned int>(textureArrays & 0xFFFF'FFFF),
+                static_cast<unsigned int>(mCommands.size()),
+                0
+            });
+        }
+
+        if (newBucket || RenderQueue::getBatch(item.key) != RenderQueue::getBatch(items[i - 1].key))
+        {
+            const MeshArena::drawRange &range = mPackets[item.instance].range;
+            mCommands.push_back({
+                range.indexCount, 0, range.firstIndex, range.baseVertex, static_cast<unsigned int>(i)
+            });
+            ++mBuckets.back().count;
+        }
+        ++mCommands.back().instanceCount;
+    }
+}
+
+size_t RendererSystem::findChunkCount(size_t count) const
+{
+    // Matches View::parallelForEach(): small lists aren't worth waking the workers for, and a few chunks per thread
+    // lets the pool balance out chunks that cull more than others.
+    constexpr size_t serialThreshold { 1024 };
+    constexpr size_t minChunkSize { 256 };
+    const ThreadPool *threadPool = getThreadPool();
+    if (!threadPool || threadPool->size() == 0 || count < serialThreshold) { return 1; }
+
+    const size_t threadCount = threadPool->size() + 1;
+    return std::max<size_t>(1, std::min(count / minChunkSize, threadCount * 4));
+}
+
+void RendererSystem::gatherFromSpatialSystem(const glm::mat4 &vpMatrix)
+{
+    // Every entity in the trees is tested, even if most are rejected with their parent node.
+    mTestedCount = mSpatialSystem->mEntities.size();
+    mSpatialSystem->queryFrustum(FrustumCuller::extractPlanes(vpMatrix), [this](ecs::entity entity) {
+        mVisibleEntities.push_back(entity);
+    });
+}
+
+void RendererSystem::gatherByCulling(const glm::mat4 &vpMatrix)
+{
+    mCandidates.clear();
+    mFrustumCuller.clear();
+    mFrustumCuller.setFrustum(vpMatrix);
+    view<const WorldTransform, const Bounds>().each(
+        [this](ecs::entity entity, const WorldTransform &world, const Bounds &bounds) {
+            // The sphere has to grow with the largest scale to still cover the mesh after a non-uniform scale.
+            const float scaleSquared = std::max({
+                glm::dot(glm::vec3(world.matrix[0]), glm::vec3(world.matrix[0])),
+                glm::dot(glm::vec3(world.matrix[1]), glm::vec3(world.matrix[1])),
+                glm::dot(glm::vec3(world.matrix[2]), glm::vec3(world.matrix[2]))
+            });
+            mFrustumCuller.add(glm::vec3(world.matrix * glm::vec4(bounds.centre, 1.f)),
+                               bounds.radius * std::sqrt(scaleSquared));
+            mCandidates.push_back(entity);
+        });
+
+    mTestedCount = mCandidates.size();
+    for (const unsigned int index : mFrustumCuller.cull()) { mVisibleEntities.push_back(mCandidates[index]); }
+}
+
+bool RendererSystem::rasterizeOccluders(const glm::mat4 &vpMatrix)
+{
+    if (!mOccluderSystem || mOccluderSystem->mEntities.empty()) { return false; }
+
+    mOcclusionCuller.begin(vpMatrix);
+    mOccluderSystem->rasterize(mOcclusionCuller, mMeshRegistry);
+    mOcclusionCuller.buildHiZ();
+    return true;
+}
+
+void RendererSystem::addPacket(packetList &list, const MeshHandle &meshHandle, const RendererUniforms &uniforms,
+                               const WorldTransform &world, float depth)
+{
+    const unsigned int materialOffset = mMaterialProcessor->getMaterialOffset(uniforms.materialIds);
+    const unsigned int textures = list.textures.find(
+        static_cast<uint64_t>(uniforms.diffuseTexturesId) << 32 | uniforms.normalMapId);
+    const unsigned int batch = list.batches.find(static_cast<uint64_t>(meshHandle.id) << 32 | materialOffset);
+    const RenderQueue::pass renderPass = mMaterialProcessor->isTransparent(uniforms.materialIds)
+        ? RenderQueue::pass::Transparent
+        : RenderQueue::pass::Opaque;
+
+    // Basic.shader is the only shader for now.
+    list.packets.push_back({
+        RenderQueue::makeKey(renderPass, 0, 0, 0, depth),
+        textures,
+        batch,
+        mMeshRegistry.getDrawRange(meshHandle),
+        { world.matrix, materialOffset }
+    });
+}
+
+unsigned int RendererSystem::idTable::find(uint64_t value)
+{
+    const auto [it, inserted] = ids.try_emplace(value, static_cast<unsigned int>(values.size()));
+    if (inserted) { values.push_back(value); }
+    return it->second;
+}
+
+void RendererSystem::idTable::clear()
+{
+    ids.clear();
+    values.clear();
+}
+
+unsigned int RendererSystem::localIdTable::find(uint64_t value)
+{
+    const unsigned int id = local.find(value);
+    if (id == shared.size()) { shared.push_back(unshared); }
+    use(id);
+    return id;
+}
+
+void RendererSystem::localIdTable::use(unsigned int id)
+{
+    if (shared[id] != unshared) { return; }
+    shared[id] = queued;
+    queue.push_back(id);
+}
+
+void RendererSystem::localIdTable::share(idTable &table)
+{
+    for (const unsigned int id : queue) { shared[id] = table.find(local.values[id]); }
+    queue.clear();
+}
+
+void RendererSystem::localIdTable::unshare()
+{
+    std::fill(shared.begin(), shared.end(), unshared);
+    queue.clear();
+}
+
+void RendererSystem::localIdTable::clear()
+{
+    local.clear();
+    shared.clear();
+    queue.clear();
 }
@@ -13,12 +13,14 @@
 #include <string>
 #include <sstream>
 #include <glew.h>
+#include <type_traits>
 
 
 Shader::Shader(const std::string &filepath) : mFilePath(filepath), mRendererId(0)
 {
     shaderProgramSource source = parseShader(filepath);
     mRendererId = createShader(source.vertexSource, source.fragmentSource);
+    reflectUniforms();
 }
 
 Shader::~Shader()
@@ -36,65 +38,133 @@ void Shader::unBind()
     glUseProgram(0);
 }
 
-void Shader::setUniform(const std::string &name, int value)
+void Shader::setUniform(UniformHandle<int> handle, int value) const
 {
-    glUniform1i(getUniformLocation(name), value);
+    glUniform1i(handle.location, value);
 }
 
-void Shader::setUniform(const std::string &name, const glm::mat4 &mat4)
+void Shader::setUniform(UniformHandle<unsigned int> handle, unsigned int value) const
+{
+    glUniform1ui(handle.location, value);
+}
+
+void Shader::setUniform(UniformHandle<glm::mat4> handle, const glm::mat4 &mat4) const
 {
     // glm stores the matrix in the correct order so that we don't have to transpose it.
-    glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &mat4[0][0]);
+    glUniformMatrix4fv(handle.location, 1, GL_FALSE, &mat4[0][0]);
+}
+
+void Shader::setUniform(UniformHandle<glm::vec4> handle, const glm::vec4 &vec4) const
+{
+    glUniform4f(handle.location, vec4.x, vec4.y, vec4.z, vec4.w);
+}
+
+void Shader::setUniform(UniformHandle<float> handle, float value) const
+{
+    glUniform1f(handle.location, value);
+}
+
+void Shader::setUniform(UniformHandle<glm::vec2> handle, const glm::vec2 &value) const
+{
+    glUniform2f(handle.location, value.x, value.y);
 }
 
-void Shader::setUniform(const std::string &name, const glm::vec4 &vec4)
+void Shader::setUniform(UniformHandle<glm::vec3> handle, const glm::vec3 &value) const
 {
-    glUniform4f(getUniformLocation(name), vec4.x, vec4.y, vec4.z, vec4.w);
+    glUniform3f(handle.location, value.x, value.y, value.z);
 }
 
-void Shader::setUniform(const std::string &name, float value)
+void Shader::setUniform(UniformHandle<int> handle, const int *values, int count) const
 {
-    glUniform1f(getUniformLocation(name), value);
+    glUniform1iv(handle.location, count, values);
 }
 
-void Shader::setUniform(const std::string &name, const glm::vec2 &value)
+void Shader::setUniform(UniformHandle<float> handle, const float *values, int count) const
 {
-    glUniform2f(getUniformLocation(name), value.x, value.y);
+    glUniform1fv(handle.location, count, values);
 }
 
-void Shader::setUniform(const std::string &name, const glm::vec3 &value)
+void Shader::setUniform(UniformHandle<glm::vec3> handle, const glm::vec3 *values, int count) const
 {
-    glUniform3f(getUniformLocation(name), value.x, value.y, value.z);
+    glUniform3fv(handle.location, count, &values[0][0]);
 }
 
-void Shader::setUniform(const std::string &name, const int *values, int count)
+template<typename T>
+UniformHandle<T> Shader::getUniform(const std::string &name) const
 {
-    glUniform1iv(getUniformLocation(name), count, values);
+    unsigned int expectedType = GL_NONE;
+    if constexpr (std::is_same_v<T, int>)                { expectedType = GL_INT; }
+    else if constexpr (std::is_same_v<T, unsigned int>)  { expectedType = GL_UNSIGNED_INT; }
+    else if constexpr (std::is_same_v<T, float>)         { expectedType = GL_FLOAT; }
+    else if constexpr (std::is_same_v<T, glm::vec2>)     { expectedType = GL_FLOAT_VEC2; }
+    else if constexpr (std::is_same_v<T, glm::vec3>)     { expectedType = GL_FLOAT_VEC3; }
+    else if constexpr (std::is_same_v<T, glm::vec4>)     { expectedType = GL_FLOAT_VEC4; }
+    else if constexpr (std::is_same_v<T, glm::mat4>)     { expectedType = GL_FLOAT_MAT4; }
+    return { findUniform(name, expectedType) };
 }
 
-void Shader::setUniform(const std::string &name, const float *values, int count)
+template UniformHandle<int>          Shader::getUniform<int>(const std::string &) const;
+template UniformHandle<unsigned int> Shader::getUniform<unsigned int>(const std::string &) const;
+template UniformHandle<float>        Shader::getUniform<float>(const std::string &) const;
+template UniformHandle<glm::vec2>    Shader::getUniform<glm::vec2>(const std::string &) const;
+template UniformHandle<glm::vec3>    Shader::getUniform<glm::vec3>(const std::string &) const;
+template UniformHandle<glm::vec4>    Shader::getUniform<glm::vec4>(const std::string &) const;
+template UniformHandle<glm::mat4>    Shader::getUniform<glm::mat4>(const std::string &) const;
+
+void Shader::reflectUniforms()
 {
-    glUniform1fv(getUniformLocation(name), count, values);
+    int count = 0;
+    glGetProgramInterfaceiv(mRendererId, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+
+    const GLenum properties[] { GL_NAME_LENGTH, GL_TYPE, GL_LOCATION, GL_ARRAY_SIZE, GL_BLOCK_INDEX };
+    constexpr int propertyCount = sizeof(properties) / sizeof(GLenum);
+    std::string name;
+    for (int i = 0; i < count; ++i)
+    {
+        int values[propertyCount];
+        glGetProgramResourceiv(mRendererId, GL_UNIFORM, i, propertyCount, properties, propertyCount, nullptr, values);
+
+        // Members of uniform and storage blocks don't have locations.
+        if (values[4] != -1) { continue; }
+
+        name.resize(values[0]);
+        glGetProgramResourceName(mRendererId, GL_UNIFORM, i, values[0], nullptr, name.data());
+        name.pop_back();  // The length includes the null terminator.
+        mUniforms[name] = { values[2], static_cast<unsigned int>(values[1]), values[3] };
+    }
 }
 
-void Shader::setUniform(const std::string &name, const glm::vec3 &values, int count)
+bool Shader::hasUniform(const std::string &name) const
 {
-    glUniform3fv(getUniformLocation(name), count, &values[0]);
+    return find(name) != mUniforms.end();
 }
 
-int Shader::getUniformLocation(const std::string &name)
+std::unordered_map<std::string, Shader::uniformInfo>::const_iterator Shader::find(const std::string &name) const
 {
-    if (mUniformLocationCache.find(name) != mUniformLocationCache.end())
+    auto it = mUniforms.find(name);
+    if (it == mUniforms.end() && !name.empty() && name.back() != ']') { it = mUniforms.find(name + "[0]"); }
+    return it;
+}
+
+int Shader::findUniform(const std::string &name, unsigned int expectedType) const
+{
+    const auto it = find(name);
+    if (it == mUniforms.end())
     {
-        return mUniformLocationCache[name];
+        debug::log("Warning: uniform '" + name + "' doesn't exist in " + mFilePath + "!", debug::severity::Minor);
+        return -1;
     }
-    int location = glGetUniformLocation(mRendererId, name.c_str());
-    if (location == -1)
+
+    // Samplers are set with the index of a texture unit.
+    const unsigned int type = it->second.type;
+    const bool isSampler = type == GL_SAMPLER_2D || type == GL_SAMPLER_2D_ARRAY || type == GL_SAMPLER_CUBE;
+    const bool isCompatible = type == expectedType || (expectedType == GL_INT && (isSampler || type == GL_BOOL));
+    if (!isCompatible)
     {
-        debug::log("Warning: uniform '" + name + "' doesn't exist!", debug::severity::Minor);
+        debug::log("Warning: uniform '" + name + "' is set with the wrong type!", debug::severity::Minor);
+        return -1;
     }
-    mUniformLocationCache[name] = location;
-    return location;
+    return it->second.location;
 }
 
 shaderProgramSource Shader::parseShader(const std::string &filepath)
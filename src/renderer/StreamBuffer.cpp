@@ -0,0 +1,42 @@
+/**
+ * @file StreamBuffer.cpp
+ * @brief A GPU buffer whose contents are replaced every frame.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "StreamBuffer.h"
+
+#include <glew.h>
+#include <algorithm>
+
+StreamBuffer::StreamBuffer()
+{
+    glCreateBuffers(1, &mId);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    glDeleteBuffers(1, &mId);
+}
+
+void StreamBuffer::upload(const void *data, size_t size)
+{
+    if (size == 0) { return; }
+
+    // Grows by doubling so that a slowly rising draw count doesn't reallocate every frame.
+    if (size > mCapacity) { mCapacity = std::max(size, mCapacity * 2); }
+    glNamedBufferData(mId, static_cast<GLsizeiptr>(mCapacity), nullptr, GL_STREAM_DRAW);
+    glNamedBufferSubData(mId, 0, static_cast<GLsizeiptr>(size), data);
+}
+
+void StreamBuffer::bindBase(unsigned int target, unsigned int index) const
+{
+    glBindBufferBase(target, index, mId);
+}
+
+void StreamBuffer::bind(unsigned int target) const
+{
+    glBindBuffer(target, mId);
+}
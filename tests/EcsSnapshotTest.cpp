@@ -0,0 +1,199 @@
+/**
+ * @file EcsSnapshotTest.cpp
+ * @brief Saves a world to a snapshot, loads it into a fresh director and checks that nothing changed.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "EcsDirector.h"
+#include "System.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace test
+{
+    int failures = 0;
+
+    void check(bool condition, std::string_view message)
+    {
+        if (condition) { return; }
+        std::cerr << "FAILED: " << message << "\n";
+        ++failures;
+    }
+
+    /** Trivially copyable, so written as a raw column. */
+    struct Position
+    {
+        float x { 0.f };
+        float y { 0.f };
+        float z { 0.f };
+
+        bool operator==(const Position &other) const = default;
+    };
+
+    /** Holds heap memory, so needs a serializer. */
+    struct Name
+    {
+        std::string value;
+        std::vector<int> tags;
+
+        bool operator==(const Name &other) const = default;
+    };
+
+    /** Has no serializer, so is left out of snapshots. */
+    struct Scratch
+    {
+        std::vector<int> values;
+    };
+
+    class PositionSystem : public System {};
+
+    std::shared_ptr<PositionSystem> registerWorld(EcsDirector &director, bool reversed)
+    {
+        // Loading matches components by type, so the order that they are registered in shouldn't matter.
+        if (reversed)
+        {
+            director.registerComponent<Scratch>();
+            director.registerComponent<Name>();
+            director.registerComponent<Position>();
+        }
+        else
+        {
+            director.registerComponent<Position>();
+            director.registerComponent<Name>();
+            director.registerComponent<Scratch>();
+        }
+
+        director.registerSerializer<Name>(
+            [](SnapshotWriter &writer, const Name &name) {
+                writer.write(name.value);
+                writer.write(name.tags);
+            },
+            [](SnapshotReader &reader, Name &name) {
+                reader.read(name.value);
+                reader.read(name.tags);
+            });
+
+        auto system = director.registerSystem<PositionSystem>();
+        director.setSystemSignature<PositionSystem, Position>();
+        return system;
+    }
+
+    std::vector<char> readFile(const std::filesystem::path &path)
+    {
+        std::ifstream file(path, std::ios_base::binary);
+        return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    }
+}
+
+int main()
+{
+    using namespace test;
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::filesystem::path firstPath = directory / "ecs_snapshot_test_first.bin";
+    const std::filesystem::path secondPath = directory / "ecs_snapshot_test_second.bin";
+    const std::filesystem::path thirdPath = directory / "ecs_snapshot_test_third.bin";
+
+    EcsDirector original;
+    const auto originalSystem = registerWorld(original, false);
+
+    std::vector<ecs::entity> entities;
+    for (int i = 0; i < 16; ++i)
+    {
+        const ecs::entity entity = original.createEntity();
+        const float value = static_cast<float>(i);
+        original.addComponent(entity, Position { value, value * 2.f, value * 3.f });
+        if (i % 2 == 0) { original.addComponent(entity, Name { "entity " + std::to_string(i), { i, i + 1 } }); }
+        if (i % 3 == 0) { original.addComponent(entity, Scratch { { i } }); }
+        entities.push_back(entity);
+    }
+
+    // Destroying leaves indices on the free list. Reusing one makes the old handle stale.
+    std::vector<ecs::entity> staleEntities { entities[3], entities[7], entities[12] };
+    for (const ecs::entity entity : staleEntities) { original.destroyEntity(entity); }
+    const ecs::entity reused = original.createEntity();
+    original.addComponent(reused, Name { "reused", { } });
+    check(ecs::indexOf(reused) == ecs::indexOf(entities[12]) || ecs::indexOf(reused) == ecs::indexOf(entities[3])
+          || ecs::indexOf(reused) == ecs::indexOf(entities[7]), "a destroyed index is reused");
+    check(!original.isAlive(entities[3]) && !original.isAlive(entities[7]) && !original.isAlive(entities[12]),
+          "destroyed handles are stale before saving");
+
+    std::vector<ecs::entity> aliveEntities;
+    for (const ecs::entity entity : entities)
+    {
+        if (original.isAlive(entity)) { aliveEntities.push_back(entity); }
+    }
+    aliveEntities.push_back(reused);
+
+    original.saveSnapshot(firstPath.string());
+
+    EcsDirector loaded;
+    const auto loadedSystem = registerWorld(loaded, true);
+    loaded.loadSnapshot(firstPath.string());
+
+    for (const ecs::entity entity : aliveEntities)
+    {
+        check(loaded.isAlive(entity), "every living entity is alive after loading");
+        check(loaded.hasComponent<Position>(entity) == original.hasComponent<Position>(entity),
+              "raw columns keep the same entities");
+        check(loaded.hasComponent<Name>(entity) == original.hasComponent<Name>(entity),
+              "serialized columns keep the same entities");
+        check(!loaded.hasComponent<Scratch>(entity), "components without a serializer are left out");
+
+        if (original.hasComponent<Position>(entity))
+        {
+            check(loaded.getComponent<const Position>(entity) == original.getComponent<const Position>(entity),
+                  "raw components are copied exactly");
+        }
+        if (original.hasComponent<Name>(entity))
+        {
+            check(loaded.getComponent<const Name>(entity) == original.getComponent<const Name>(entity),
+                  "serialized components are read back exactly");
+        }
+    }
+
+    for (const ecs::entity entity : staleEntities)
+    {
+        check(!loaded.isAlive(entity), "stale handles stay stale after loading");
+    }
+
+    // Scratch is dropped and columns are written in registration order, so the first file differs from the
+    // second. Loading and saving again with the same registration must not change anything, byte for byte.
+    loaded.saveSnapshot(secondPath.string());
+    EcsDirector reloaded;
+    registerWorld(reloaded, true);
+    reloaded.loadSnapshot(secondPath.string());
+    reloaded.saveSnapshot(thirdPath.string());
+    check(readFile(secondPath) == readFile(thirdPath), "a loaded world saves the same snapshot");
+
+    check(loadedSystem->mEntities.size() == originalSystem->mEntities.size(), "systems are given the loaded entities");
+    for (const ecs::entity entity : originalSystem->mEntities)
+    {
+        check(loadedSystem->mEntities.contains(entity), "systems are given the same entities");
+    }
+
+    // The free list must be in the same order, so both worlds hand out the same handles next.
+    for (int i = 0; i < 3; ++i)
+    {
+        check(loaded.createEntity() == original.createEntity(), "the free list is restored in the same order");
+    }
+
+    std::filesystem::remove(firstPath);
+    std::filesystem::remove(secondPath);
+    std::filesystem::remove(thirdPath);
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " checks failed.\n";
+        return 1;
+    }
+    std::cout << "All snapshot checks passed.\n";
+    return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file OcclusionCullerTest.cpp
+ * @brief Rasterises a few occluders and checks that the HiZ test never hides a box that the per pixel test can see.
+ * Project: RenderPipeline
+ * Initial Version: 19/10/2026
+ * @author Ryan Purse
+ */
+
+#include "OcclusionCuller.h"
+
+#include <glm.hpp>
+#include <gtc/matrix_transform.hpp>
+#include <gtc/quaternion.hpp>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace test
+{
+    int failures = 0;
+
+    void check(bool condition, std::string_view message)
+    {
+        if (condition) { return; }
+        std::cerr << "FAILED: " << message << "\n";
+        ++failures;
+    }
+
+    const glm::vec3 boxMin { -1.f };
+    const glm::vec3 boxMax { 1.f };
+
+    // A unit cube wound counter-clockwise from the outside, so that its front faces are drawn.
+    const std::vector<glm::vec3> cubePositions {
+        { -1.f, -1.f, -1.f }, { 1.f, -1.f, -1.f }, { 1.f, 1.f, -1.f }, { -1.f, 1.f, -1.f },
+        { -1.f, -1.f,  1.f }, { 1.f, -1.f,  1.f }, { 1.f, 1.f,  1.f }, { -1.f, 1.f,  1.f },
+    };
+
+    const std::vector<unsigned int> cubeIndices {
+        4, 5, 6, 4, 6, 7,  // +z
+        1, 0, 3, 1, 3, 2,  // -z
+        5, 1, 2, 5, 2, 6,  // +x
+        0, 4, 7, 0, 7, 3,  // -x
+        7, 6, 2, 7, 2, 3,  // +y
+        0, 1, 5, 0, 5, 4,  // -y
+    };
+
+    glm::mat4 makeModel(const glm::vec3 &position, const glm::vec3 &halfSize, const glm::quat &rotation=glm::quat())
+    {
+        const glm::mat4 translation = glm::translate(glm::mat4(1.f), position);
+        return translation * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.f), halfSize);
+    }
+
+    /** Checks boxes scattered around the occluders. @return The number of boxes that the HiZ test hid. */
+    size_t checkRandomBoxes(const OcclusionCuller &culler, std::mt19937 &random, int count)
+    {
+        std::uniform_real_distribution<float> x(-8.f, 8.f);
+        std::uniform_real_distribution<float> y(-5.f, 5.f);
+        std::uniform_real_distribution<float> z(-20.f, 4.5f);
+        std::uniform_real_distribution<float> size(0.05f, 1.5f);
+        std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+        size_t hiddenCount = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const glm::vec3 position(x(random), y(random), z(random));
+            const glm::vec3 halfSize(size(random), size(random), size(random));
+            const glm::quat rotation(glm::vec3(angle(random), angle(random), angle(random)));
+            const glm::mat4 model = makeModel(position, halfSize, rotation);
+
+            const bool visible = culler.isVisible(boxMin, boxMax, model);
+            if (culler.isVisibleReference(boxMin, boxMax, model) && !visible)
+            {
+                check(false, "the HiZ test hides box " + std::to_string(i) + " which the reference can see");
+            }
+            if (!visible) { ++hiddenCount; }
+        }
+        return hiddenCount;
+    }
+
+    void checkCuller(OcclusionCuller &culler, const glm::mat4 &vpMatrix)
+    {
+        culler.begin(vpMatrix);
+        culler.addOccluder(cubePositions, cubeIndices, makeModel(glm::vec3(0.f), glm::vec3(4.f, 3.f, 0.2f)));
+        culler.addOccluder(cubePositions, cubeIndices, makeModel(glm::vec3(-5.f, 2.f, -4.f), glm::vec3(1.5f)));
+        culler.addOccluder(cubePositions, cubeIndices, makeModel(glm::vec3(5.f, -1.f, -2.f), glm::vec3(1.f, 2.f, 1.f),
+                                                                 glm::quat(glm::vec3(0.f, 0.7f, 0.f))));
+        culler.buildHiZ();
+
+        check(culler.getTriangleCount() > 0, "the occluders are rasterised");
+
+        const glm::mat4 behindWall = makeModel(glm::vec3(0.f, 0.f, -3.f), glm::vec3(0.5f));
+        check(!culler.isVisibleReference(boxMin, boxMax, behindWall), "the reference hides a box behind the wall");
+        check(!culler.isVisible(boxMin, boxMax, behindWall), "the HiZ test hides a box behind the wall");
+
+        const glm::mat4 inFront = makeModel(glm::vec3(0.f, 0.f, 2.f), glm::vec3(0.5f));
+        check(culler.isVisible(boxMin, boxMax, inFront), "a box in front of the wall is visible");
+
+        const glm::mat4 acrossNearPlane = makeModel(glm::vec3(0.f, 0.f, 5.f), glm::vec3(0.5f));
+        check(culler.isVisible(boxMin, boxMax, acrossNearPlane), "a box across the near plane is visible");
+
+        std::mt19937 random(1234);
+        check(checkRandomBoxes(culler, random, 4096) > 0, "the HiZ test hides some of the random boxes");
+    }
+}
+
+int main()
+{
+    using namespace test;
+
+    const glm::mat4 projection = glm::perspective(glm::radians(60.f), 2.f, 0.1f, 100.f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.f, 0.f, 5.f), glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+    const glm::mat4 vpMatrix = projection * view;
+
+    OcclusionCuller culler;
+    checkCuller(culler, vpMatrix);
+
+    // Sizes that aren't a power of two leave odd rows and columns at the bottom of the mip chain.
+    culler.resize(200, 72);
+    checkCuller(culler, vpMatrix);
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " checks failed.\n";
+        return 1;
+    }
+    std::cout << "All occlusion culler checks passed.\n";
+    return 0;
+}